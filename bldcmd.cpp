@@ -0,0 +1,110 @@
+// bldcmd: Daemon owning mBldcm IPs and serving clients through MotorChannel.
+#include <libbldcm.hpp>
+#include <libbldcm/bus.hpp>
+#include <libbldcm/sim_bus.hpp>
+#include <libbldcm/motor_channel.hpp>
+#include <libbldcm/motor_daemon.hpp>
+
+#include <libfpgasoc.hpp>
+#include <memory>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+
+#include <csignal>
+#include <unistd.h>
+
+using std::shared_ptr;
+using std::make_shared;
+using std::vector;
+using std::string;
+using std::atomic;
+using std::cerr;
+using std::endl;
+
+namespace {
+atomic<bool> isStopRequested(false);
+
+void onSignal(int)
+{
+	isStopRequested.store(true);
+}
+
+void usage(const char *prog)
+{
+	cerr << "Usage: " << prog << " [-n name] [-c clock_hz] [-p poll_us] [-r ring_size] [-s] base_addr..." << endl
+	     << "  -n name      : Name of shared memory channel (default: /bldcmd)" << endl
+	     << "  -c clock_hz  : Clock frequency of mBldcm [Hz] (default: 50000000)" << endl
+	     << "  -p poll_us   : Polling period [us] (default: 1000)" << endl
+	     << "  -r ring_size : Size of command ring (default: 1024)" << endl
+	     << "  -s           : Use simulated mBldcm instead of HW" << endl;
+}
+} // End of anonymous namespace
+
+int main(int argc, char *argv[])
+{
+	string   name       = "/bldcmd";
+	int64_t  clockHz    = 50000000;
+	int64_t  pollUs     = 1000;
+	uint32_t ringSize   = bldcm::MotorChannel::DefaultRingSize;
+	bool     isSimulate = false;
+	int      opt;
+
+	while ((opt = getopt(argc, argv, "n:c:p:r:sh")) != -1) {
+		switch (opt) {
+			case 'n': name       = optarg; break;
+			case 'c': clockHz    = std::strtoll(optarg, nullptr, 0); break;
+			case 'p': pollUs     = std::strtoll(optarg, nullptr, 0); break;
+			case 'r': ringSize   = static_cast<uint32_t>(std::strtoul(optarg, nullptr, 0)); break;
+			case 's': isSimulate = true; break;
+			default:
+				usage(argv[0]);
+				return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (optind >= argc) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try {
+		shared_ptr<bldcm::Bus> bus;
+		shared_ptr<bldcm::SimBus> simBus;
+		vector<shared_ptr<bldcm::Motor>> motors;
+
+		if (isSimulate) {
+			simBus = make_shared<bldcm::SimBus>();
+			bus = simBus;
+		} else {
+			bus = make_shared<bldcm::FpgasocBus>(make_shared<Fpgasoc>());
+		}
+
+		for (int i = optind; i < argc; i++) {
+			const uint32_t baseAddr = static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 0));
+
+			if (simBus) {
+				simBus->addDevice(baseAddr);
+			}
+			motors.push_back(make_shared<bldcm::Motor>(bus, bldcm::Hz(clockHz), baseAddr));
+		}
+
+		auto channel = make_shared<bldcm::MotorChannel>(name, static_cast<uint32_t>(motors.size()), ringSize);
+		bldcm::MotorDaemon daemon(channel, motors);
+
+		std::signal(SIGINT, onSignal);
+		std::signal(SIGTERM, onSignal);
+
+		daemon.run(isStopRequested, std::chrono::microseconds(pollUs));
+	} catch (const std::exception &e) {
+		cerr << argv[0] << ": " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,215 @@
+#include <libbldcm/commutation_sequencer.hpp>
+#include <libbldcm/register_map.hpp>
+#include <libbldcm.hpp>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+#include <utility>
+
+using std::vector;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::runtime_error;
+using std::invalid_argument;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+using std::chrono::duration_cast;
+
+namespace bldcm {
+// Utilities
+static void insertValue(uint32_t &updatedValue, const uint32_t insertedValue, const uint32_t bitPos, const uint32_t bitMask)
+{
+	updatedValue = (updatedValue & (~bitMask)) | ((insertedValue << bitPos) & bitMask);
+}
+
+//========  CommutationSequencer class ========
+// Public
+CommutationSequencer::CommutationSequencer(Motor &motor) noexcept(false)
+	: _motor(motor), _ctrlWords(), _phase(0), _isRunning(false), _isStopRequested(false),
+	  _spinMargin(std::chrono::microseconds(50)),
+	  _stats{0, nanoseconds::max(), nanoseconds::min(), nanoseconds::zero()}
+{
+	this->prepare();
+}
+
+CommutationSequencer::~CommutationSequencer()
+{
+	this->stop();
+}
+
+void CommutationSequencer::prepare() noexcept(false)
+{
+	CtrlReg &ctrl = this->_motor.regMap().ctrl;
+
+	if (this->_isRunning.load()) {
+		throw runtime_error("Commutation sequence is running.");
+	}
+
+	if (ctrl.cacheStatus() == CtrlReg::CacheState::initialized) {
+		ctrl.updateCache();
+	} else if (ctrl.cacheStatus() == CtrlReg::CacheState::modified) {
+		throw runtime_error("Cache of CtrlReg is modified at preparing commutation.");
+	}
+
+	const uint32_t base = ctrl.reg(true);
+
+	for (std::size_t i = 0; i < _PhaseNum; i++) {
+		uint32_t word = base;
+
+		insertValue(word, static_cast<uint32_t>(i), CtrlReg::Phase::Bit::Pos, CtrlReg::Phase::Bit::Mask);
+		insertValue(word, static_cast<uint32_t>(CtrlReg::WPhase::Val::Write), CtrlReg::WPhase::Bit::Pos, CtrlReg::WPhase::Bit::Mask);
+		this->_ctrlWords[i] = word;
+	}
+
+	this->_phase = static_cast<int>(ctrl.phase(true));
+}
+
+void CommutationSequencer::start(const vector<nanoseconds> &timetable, const Direction dir) noexcept(false)
+{
+	if (this->_isRunning.load()) {
+		throw runtime_error("Commutation sequence is already running.");
+	}
+
+	if (this->_thread.joinable()) {
+		this->_thread.join();
+	}
+
+	{
+		lock_guard<mutex> lock(this->_mtx);
+		this->_stats     = Stats{0, nanoseconds::max(), nanoseconds::min(), nanoseconds::zero()};
+		this->_exception = nullptr;
+	}
+
+	this->_isStopRequested.store(false);
+	this->_isRunning.store(true);
+	this->_thread = std::thread(&CommutationSequencer::_run, this, timetable, dir);
+}
+
+void CommutationSequencer::stop() noexcept(true)
+{
+	{
+		// Set under the lock not to lose the wake up of the sequence thread.
+		lock_guard<mutex> lock(this->_mtx);
+		this->_isStopRequested.store(true);
+	}
+	this->_cv.notify_all();
+
+	if (this->_thread.joinable()) {
+		this->_thread.join();
+	}
+}
+
+void CommutationSequencer::wait() noexcept(false)
+{
+	std::exception_ptr exception;
+
+	if (this->_thread.joinable()) {
+		this->_thread.join();
+	}
+
+	{
+		lock_guard<mutex> lock(this->_mtx);
+		exception = std::exchange(this->_exception, nullptr);
+	}
+
+	if (exception) {
+		std::rethrow_exception(exception);
+	}
+}
+
+bool CommutationSequencer::isRunning() const noexcept(true)
+{
+	return this->_isRunning.load();
+}
+
+void CommutationSequencer::spinMargin(const nanoseconds &margin) noexcept(true)
+{
+	this->_spinMargin = margin;
+}
+
+CommutationSequencer::Stats CommutationSequencer::stats() const noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_stats;
+}
+
+vector<nanoseconds> CommutationSequencer::accelerationTable(const nanoseconds &startInterval,
+                                                            const nanoseconds &endInterval,
+                                                            const std::size_t stepNum) noexcept(false)
+{
+	vector<nanoseconds> ret;
+
+	if ((startInterval <= nanoseconds::zero()) || (endInterval <= nanoseconds::zero())) {
+		throw invalid_argument("Interval of commutation must be positive.");
+	}
+
+	ret.reserve(stepNum);
+
+	// Speed is proportional to the reciprocal of interval.
+	const double startSpeed = 1.0 / static_cast<double>(startInterval.count());
+	const double endSpeed   = 1.0 / static_cast<double>(endInterval.count());
+
+	for (std::size_t i = 0; i < stepNum; i++) {
+		const double ratio = (stepNum > 1) ? (static_cast<double>(i) / static_cast<double>(stepNum - 1)) : 1.0;
+		const double speed = startSpeed + ((endSpeed - startSpeed) * ratio);
+		ret.push_back(nanoseconds(static_cast<nanoseconds::rep>(1.0 / speed)));
+	}
+
+	return ret;
+}
+
+// Private
+void CommutationSequencer::_run(const vector<nanoseconds> timetable, const Direction dir) noexcept(true)
+{
+	CtrlReg &ctrl = this->_motor.regMap().ctrl;
+	const int step = (dir == Direction::forward) ? 1 : static_cast<int>(_PhaseNum - 1);
+	steady_clock::time_point target = steady_clock::now();
+
+	try {
+		for (const nanoseconds &interval : timetable) {
+			target += interval;
+			const int      phase = (this->_phase + step) % static_cast<int>(_PhaseNum);
+			const uint32_t word  = this->_ctrlWords[static_cast<std::size_t>(phase)];
+
+			// Sleep coarsely then spin until the exact time. stop() wakes up the sleep.
+			{
+				unique_lock<mutex> lock(this->_mtx);
+				if (this->_cv.wait_until(lock, target - this->_spinMargin, [this] { return this->_isStopRequested.load(); })) {
+					break;
+				}
+			}
+			while (steady_clock::now() < target) {
+				// Busy wait.
+			}
+
+			const nanoseconds error = duration_cast<nanoseconds>(steady_clock::now() - target);
+			ctrl.reg(word);
+			// Advance only after the write, so that the next start() continues from the written phase.
+			this->_phase = phase;
+
+			// Publish every step so that stats() can be read during the sequence.
+			lock_guard<mutex> lock(this->_mtx);
+			Stats &stats = this->_stats;
+
+			stats.stepNum++;
+			stats.minError = std::min(stats.minError, error);
+			stats.maxError = std::max(stats.maxError, error);
+			stats.totalAbsError += (error < nanoseconds::zero()) ? -error : error;
+		}
+	} catch (...) {
+		lock_guard<mutex> lock(this->_mtx);
+		this->_exception = std::current_exception();
+	}
+
+	this->_isRunning.store(false);
+}
+
+} // End of "namespace bldcm"
+
@@ -0,0 +1,241 @@
+#include <libbldcm/coro.hpp>
+#include <libbldcm.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using std::runtime_error;
+using std::string;
+using std::coroutine_handle;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+using std::chrono::duration_cast;
+
+namespace bldcm::coro {
+// Utilities
+static string errnoMessage(const string &msg)
+{
+	return msg + " (" + std::strerror(errno) + ")";
+}
+
+// Coroutine which destroys itself at its end. It's used to run spawned tasks.
+// Its frame is registered to the loop while it's alive, so that the loop can destroy unfinished ones.
+struct EventLoop::Detached {
+	struct promise_type {
+		EventLoop &loop;
+
+		promise_type(EventLoop &l, Task<void> &) noexcept : loop(l) {}
+		~promise_type() { this->loop._detached.erase(coroutine_handle<promise_type>::from_promise(*this).address()); }
+
+		Detached get_return_object()
+		{
+			this->loop._detached.insert(coroutine_handle<promise_type>::from_promise(*this).address());
+			return {};
+		}
+		std::suspend_never initial_suspend() const noexcept { return {}; }
+		std::suspend_never final_suspend() const noexcept { return {}; }
+		void return_void() const noexcept {}
+		void unhandled_exception() const noexcept { std::terminate(); }
+	};
+};
+
+//========  EventLoop class ========
+// Public
+EventLoop::EventLoop() noexcept(false)
+	: _epollFd(-1), _timerFd(-1), _wakeFd(-1)
+{
+	struct epoll_event ev;
+
+	this->_epollFd = epoll_create1(EPOLL_CLOEXEC);
+	this->_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	this->_wakeFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if ((this->_epollFd < 0) || (this->_timerFd < 0) || (this->_wakeFd < 0)) {
+		const string msg = errnoMessage("Fail to create event loop.");
+		for (const int fd : {this->_epollFd, this->_timerFd, this->_wakeFd}) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+		throw runtime_error(msg);
+	}
+
+	ev.events = EPOLLIN;
+	ev.data.fd = this->_timerFd;
+	epoll_ctl(this->_epollFd, EPOLL_CTL_ADD, this->_timerFd, &ev);
+	ev.data.fd = this->_wakeFd;
+	epoll_ctl(this->_epollFd, EPOLL_CTL_ADD, this->_wakeFd, &ev);
+}
+
+EventLoop::~EventLoop()
+{
+	// Destroy spawned tasks left by stop() or an exception. Tasks awaited by them are destroyed in a chain.
+	std::unordered_set<void *> detached;
+
+	detached.swap(this->_detached);
+	for (void *const addr : detached) {
+		coroutine_handle<>::from_address(addr).destroy();
+	}
+
+	for (const int fd : {this->_epollFd, this->_timerFd, this->_wakeFd}) {
+		if (fd >= 0) {
+			close(fd);
+		}
+	}
+}
+
+void EventLoop::spawn(Task<void> &&task) noexcept(false)
+{
+	_runDetached(*this, std::move(task));
+}
+
+void EventLoop::run() noexcept(false)
+{
+	struct epoll_event events[2];
+
+	this->_isStopRequested = false;
+
+	while ((!this->_isStopRequested) && (!this->_detached.empty()) && (!this->_exception)) {
+		const int num = epoll_wait(this->_epollFd, events, 2, -1);
+
+		if (num < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw runtime_error(errnoMessage("Fail to wait events."));
+		}
+
+		for (int i = 0; i < num; i++) {
+			uint64_t count;
+			// Only clear readiness. Expired timers are judged by time.
+			static_cast<void>(read(events[i].data.fd, &count, sizeof(count)));
+		}
+
+		const Clock::time_point now = Clock::now();
+
+		this->_armedTime = Clock::time_point::max();
+		this->_expired.clear();
+		while ((!this->_timers.empty()) && (this->_timers.top().time <= now)) {
+			this->_expired.push_back(this->_timers.top().handle);
+			this->_timers.pop();
+		}
+
+		// Waits resumed here may add new timers.
+		for (const coroutine_handle<> h : this->_expired) {
+			h.resume();
+		}
+
+		this->_armTimer();
+	}
+
+	if (this->_exception) {
+		std::rethrow_exception(std::exchange(this->_exception, nullptr));
+	}
+}
+
+void EventLoop::stop() noexcept(true)
+{
+	const uint64_t val = 1;
+
+	this->_isStopRequested = true;
+	static_cast<void>(write(this->_wakeFd, &val, sizeof(val)));
+}
+
+EventLoop::SleepAwaiter EventLoop::sleepFor(const nanoseconds &duration) noexcept(true)
+{
+	return SleepAwaiter(*this, Clock::now() + duration);
+}
+
+EventLoop::SleepAwaiter EventLoop::sleepUntil(const Clock::time_point &time) noexcept(true)
+{
+	return SleepAwaiter(*this, time);
+}
+
+std::size_t EventLoop::pendingNum() const noexcept(true)
+{
+	return this->_timers.size();
+}
+
+// Private
+void EventLoop::_schedule(const Clock::time_point &time, coroutine_handle<> h) noexcept(false)
+{
+	this->_timers.push(Timer{time, this->_timerSeq++, h});
+	this->_armTimer();
+}
+
+void EventLoop::_armTimer() noexcept(false)
+{
+	struct itimerspec spec = {};
+
+	if (this->_timers.empty() || (this->_timers.top().time >= this->_armedTime)) {
+		return;
+	}
+
+	const Clock::time_point next = this->_timers.top().time;
+	const nanoseconds sinceEpoch = duration_cast<nanoseconds>(next.time_since_epoch());
+
+	if (sinceEpoch > nanoseconds::zero()) {
+		spec.it_value.tv_sec  = static_cast<time_t>(duration_cast<seconds>(sinceEpoch).count());
+		spec.it_value.tv_nsec = static_cast<long>((sinceEpoch - duration_cast<seconds>(sinceEpoch)).count());
+	} else {
+		// Zero means disarming, so use the smallest time instead.
+		spec.it_value.tv_nsec = 1;
+	}
+
+	// steady_clock is CLOCK_MONOTONIC on Linux.
+	if (timerfd_settime(this->_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+		throw runtime_error(errnoMessage("Fail to arm timer."));
+	}
+
+	this->_armedTime = next;
+}
+
+EventLoop::Detached EventLoop::_runDetached(EventLoop &loop, Task<void> task)
+{
+	try {
+		co_await task;
+	} catch (...) {
+		if (!loop._exception) {
+			loop._exception = std::current_exception();
+		}
+	}
+}
+
+// Awaitables
+Task<void> untilStopped(EventLoop &loop, Motor &motor, const nanoseconds pollPeriod)
+{
+	while (!motor.isStopping()) {
+		co_await loop.sleepFor(pollPeriod);
+	}
+}
+
+Task<bool> untilReflected(EventLoop &loop, Motor &motor, const nanoseconds timeout, const nanoseconds pollPeriod)
+{
+	const EventLoop::Clock::time_point deadline = EventLoop::Clock::now() + timeout;
+
+	while (!motor.isReflectedFreq()) {
+		const EventLoop::Clock::time_point now = EventLoop::Clock::now();
+
+		if (now >= deadline) {
+			co_return false;
+		}
+
+		co_await loop.sleepUntil(((deadline - now) < pollPeriod) ? deadline : (now + pollPeriod));
+	}
+
+	co_return true;
+}
+
+} // End of "namespace bldcm::coro"
+
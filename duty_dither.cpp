@@ -0,0 +1,213 @@
+#include <libbldcm/duty_dither.hpp>
+#include <libbldcm/register_map.hpp>
+#include <libbldcm.hpp>
+
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::runtime_error;
+using std::out_of_range;
+using std::invalid_argument;
+using std::chrono::nanoseconds;
+using std::chrono::duration_cast;
+
+namespace bldcm {
+
+//========  DutyDither class ========
+// Public
+DutyDither::DutyDither(const nanoseconds &updatePeriod) noexcept(false)
+	: _updatePeriod(updatePeriod), _isStopRequested(false), _stats{0, 0, nanoseconds::zero()}
+{
+	if (updatePeriod <= nanoseconds::zero()) {
+		throw invalid_argument("Update period must be positive.");
+	}
+}
+
+DutyDither::~DutyDither()
+{
+	this->stop();
+}
+
+void DutyDither::add(Motor &motor) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+
+	if (this->_find(motor) != nullptr) {
+		throw invalid_argument("The motor is already added.");
+	}
+
+	const uint32_t cmp = motor.regMap().pwmCmp.pwmCmp(motor.regMap().pwmCmp.cacheStatus() == PwmCmpReg::CacheState::sync);
+
+	this->_entries.push_back(Entry{&motor, cmp, 0, 0, cmp, -1.});
+}
+
+void DutyDither::remove(const Motor &motor) noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	auto &entries = this->_entries;
+
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [&motor](const Entry &e) { return e.motor == &motor; }), entries.end());
+}
+
+void DutyDither::duty(Motor &motor, const double duty) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	Entry *entry = this->_find(motor);
+
+	if (entry == nullptr) {
+		throw invalid_argument("The motor is not added.");
+	}
+
+	if ((duty < 0.) || (duty > 100.)) {
+		throw out_of_range("PwmDuty is out of range.");
+	}
+
+	_dutyLocked(*entry, duty);
+}
+
+void DutyDither::pwmPeriod(Motor &motor, const nanoseconds &period, const int prsc) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	Entry *entry = this->_find(motor);
+
+	if (entry == nullptr) {
+		throw invalid_argument("The motor is not added.");
+	}
+
+	// PWM_CMP is rewritten by Motor based on its integer duty, so it's rewritten again for the target.
+	motor.pwmPeriod(period, prsc);
+
+	if (entry->target >= 0.) {
+		_dutyLocked(*entry, entry->target);
+	} else {
+		entry->baseCmp  = motor.regMap().pwmCmp.pwmCmp(true);
+		entry->fraction = static_cast<uint32_t>(0U);
+		entry->lastCmp  = _InvalidCmp;
+	}
+}
+
+void DutyDither::start() noexcept(false)
+{
+	if (!this->_thread.joinable()) {
+		this->_isStopRequested = false;
+		this->_thread = std::thread(&DutyDither::_run, this);
+	}
+}
+
+void DutyDither::stop() noexcept(true)
+{
+	if (this->_thread.joinable()) {
+		{
+			lock_guard<mutex> lock(this->_mtx);
+			this->_isStopRequested = true;
+		}
+		this->_cv.notify_all();
+		this->_thread.join();
+	}
+}
+
+void DutyDither::update() noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	this->_updateLocked();
+}
+
+DutyDither::Stats DutyDither::stats() noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_stats;
+}
+
+// Private
+void DutyDither::_run() noexcept(true)
+{
+	unique_lock<mutex> lock(this->_mtx);
+	auto next = std::chrono::steady_clock::now();
+
+	while (!this->_isStopRequested) {
+		this->_updateLocked();
+		next += this->_updatePeriod;
+		this->_cv.wait_until(lock, next, [this] { return this->_isStopRequested; });
+	}
+}
+
+void DutyDither::_dutyLocked(Entry &entry, const double duty) noexcept(false)
+{
+	Motor &motor = *entry.motor;
+	CtrlReg &ctrl = motor.regMap().ctrl;
+	uint16_t pwmMaxcnt;
+
+	if (ctrl.cacheStatus() == CtrlReg::CacheState::initialized) {
+		pwmMaxcnt = ctrl.pwmMaxcnt();
+	} else if (ctrl.cacheStatus() == CtrlReg::CacheState::sync) {
+		pwmMaxcnt = ctrl.pwmMaxcnt(true);
+	} else {
+		throw runtime_error("Try to fetch pwmMaxcnt but the reg cache is modified.");
+	}
+
+	if (duty == 100.) {
+		// Same as Motor::pwmDuty(100).
+		entry.baseCmp  = static_cast<uint32_t>(pwmMaxcnt) + static_cast<uint32_t>(1U);
+		entry.fraction = static_cast<uint32_t>(0U);
+	} else {
+		const double   cmp  = (static_cast<double>(pwmMaxcnt) * duty) / 100.;
+		const uint64_t cmpQ = static_cast<uint64_t>(std::llround(cmp * static_cast<double>(static_cast<uint64_t>(1U) << _FracBits)));
+
+		entry.baseCmp  = static_cast<uint32_t>(cmpQ >> _FracBits);
+		entry.fraction = static_cast<uint32_t>(cmpQ) & _FracMask;
+	}
+
+	// PWM_CMP may have been written by others, so don't trust the last written value.
+	entry.lastCmp = _InvalidCmp;
+	entry.target  = duty;
+	motor.pwmDutyCache(static_cast<int>(std::lround(duty)));
+}
+
+void DutyDither::_updateLocked() noexcept(true)
+{
+	const auto begin = std::chrono::steady_clock::now();
+
+	for (Entry &entry : this->_entries) {
+		// First-order sigma-delta: carry of the accumulator selects upper compare value.
+		entry.acc += entry.fraction;
+		const uint32_t cmp = entry.baseCmp + (entry.acc >> _FracBits);
+		entry.acc &= _FracMask;
+
+		if (cmp != entry.lastCmp) {
+			try {
+				// PWM_CMP has no other field, so whole register is written without reading.
+				entry.motor->regMap().pwmCmp.reg(cmp);
+				entry.lastCmp = cmp;
+				this->_stats.writeNum++;
+			} catch (...) {
+				// Retry at the next pass.
+			}
+		}
+	}
+
+	this->_stats.passNum++;
+	this->_stats.maxPassTime = std::max(this->_stats.maxPassTime, duration_cast<nanoseconds>(std::chrono::steady_clock::now() - begin));
+}
+
+DutyDither::Entry *DutyDither::_find(const Motor &motor) noexcept(true)
+{
+	for (Entry &entry : this->_entries) {
+		if (entry.motor == &motor) {
+			return &entry;
+		}
+	}
+
+	return nullptr;
+}
+
+} // End of "namespace bldcm"
+
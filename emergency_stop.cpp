@@ -0,0 +1,169 @@
+#include <libbldcm/emergency_stop.hpp>
+#include <libbldcm/register_map.hpp>
+#include <libbldcm.hpp>
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+using std::mutex;
+using std::lock_guard;
+using std::runtime_error;
+using std::invalid_argument;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+using std::chrono::nanoseconds;
+using std::chrono::duration_cast;
+using std::chrono::steady_clock;
+
+namespace bldcm {
+
+//========  EmergencyStop class ========
+// Public
+EmergencyStop::EmergencyStop(const std::size_t capacity) noexcept(false)
+	: _capacity(capacity), _entries(new Entry[capacity]), _entryNum(0), _triggerNum(0), _lastFailNum(0)
+{
+	if (capacity == 0) {
+		throw invalid_argument("Capacity must be positive.");
+	}
+}
+
+void EmergencyStop::add(Motor &motor) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	const std::size_t num = this->_entryNum.load(memory_order_relaxed);
+	const uint32_t word = _disabledWord(motor);
+	const std::shared_ptr<Bus> bus = motor.regMap().bus();
+	const uint32_t addr = motor.regMap().ctrl.address();
+
+	// Entries are matched by the register written at trigger(), not by the pointer to the motor,
+	// because another motor may be constructed at the address of a removed one.
+	// trigger() reads bus and addr without lock, so they are never rewritten.
+	for (std::size_t i = 0; i < num; i++) {
+		Entry &e = this->_entries[i];
+
+		if ((e.bus == bus) && (e.addr == addr)) {
+			e.motor = &motor;
+			e.word.store(word, memory_order_relaxed);
+			e.isActive.store(true, memory_order_release);
+			return;
+		}
+	}
+
+	if (num >= this->_capacity) {
+		throw runtime_error("There is no free entry in emergency stop.");
+	}
+
+	Entry &e = this->_entries[num];
+
+	e.motor = &motor;
+	e.bus   = bus;
+	e.addr  = addr;
+	e.word.store(word, memory_order_relaxed);
+	e.isActive.store(true, memory_order_relaxed);
+
+	// Publish the entry after it's filled.
+	this->_entryNum.store(num + 1, memory_order_release);
+}
+
+void EmergencyStop::remove(const Motor &motor) noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	const std::size_t num = this->_entryNum.load(memory_order_relaxed);
+
+	for (std::size_t i = 0; i < num; i++) {
+		if (this->_entries[i].motor == &motor) {
+			this->_entries[i].isActive.store(false, memory_order_release);
+		}
+	}
+}
+
+void EmergencyStop::refresh() noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	const std::size_t num = this->_entryNum.load(memory_order_relaxed);
+
+	for (std::size_t i = 0; i < num; i++) {
+		Entry &e = this->_entries[i];
+
+		if (e.isActive.load(memory_order_relaxed)) {
+			e.word.store(_disabledWord(*e.motor), memory_order_relaxed);
+		}
+	}
+}
+
+nanoseconds EmergencyStop::trigger() noexcept(true)
+{
+	const steady_clock::time_point start = steady_clock::now();
+	const std::size_t num = this->_entryNum.load(memory_order_acquire);
+	uint64_t failNum = 0;
+
+	for (std::size_t i = 0; i < num; i++) {
+		Entry &e = this->_entries[i];
+
+		if (!e.isActive.load(memory_order_acquire)) {
+			continue;
+		}
+
+		// Keep disabling the others even if a write fails.
+		try {
+			e.bus->write32(e.addr, e.word.load(memory_order_relaxed));
+		} catch (...) {
+			failNum++;
+		}
+	}
+
+	const nanoseconds elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+
+	this->_lastFailNum.store(failNum, memory_order_relaxed);
+	this->_triggerNum.fetch_add(1, memory_order_relaxed);
+
+	return elapsed;
+}
+
+void EmergencyStop::resync() noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	const std::size_t num = this->_entryNum.load(memory_order_relaxed);
+
+	for (std::size_t i = 0; i < num; i++) {
+		Entry &e = this->_entries[i];
+
+		// Staged modification of CTRL is discarded, because it was made before the stop.
+		if (e.isActive.load(memory_order_relaxed)) {
+			e.motor->regMap().ctrl.updateCache();
+		}
+	}
+}
+
+uint64_t EmergencyStop::triggerNum() const noexcept(true)
+{
+	return this->_triggerNum.load(memory_order_relaxed);
+}
+
+uint64_t EmergencyStop::lastFailNum() const noexcept(true)
+{
+	return this->_lastFailNum.load(memory_order_relaxed);
+}
+
+// Private
+uint32_t EmergencyStop::_disabledWord(Motor &motor) noexcept(false)
+{
+	CtrlReg &ctrl = motor.regMap().ctrl;
+
+	if (ctrl.cacheStatus() == CtrlReg::CacheState::initialized) {
+		ctrl.updateCache();
+	} else if (ctrl.cacheStatus() == CtrlReg::CacheState::modified) {
+		// Staged fields must not be written to hardware by trigger().
+		throw runtime_error("Cache of CtrlReg is modified at computing disabled word.");
+	}
+
+	// PHASE isn't written, because W_PHASE is cleared.
+	return ctrl.reg(true) & (~(CtrlReg::En::Bit::Mask | CtrlReg::WPhase::Bit::Mask));
+}
+
+} // End of "namespace bldcm"
+
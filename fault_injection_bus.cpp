@@ -0,0 +1,137 @@
+#include <libbldcm/fault_injection_bus.hpp>
+#include <libbldcm/bus.hpp>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+
+using std::shared_ptr;
+using std::mutex;
+using std::lock_guard;
+using std::range_error;
+using std::invalid_argument;
+using std::chrono::nanoseconds;
+
+namespace bldcm {
+
+//========  FaultInjectionBus class ========
+// Public
+FaultInjectionBus::FaultInjectionBus(const shared_ptr<Bus> &bus) noexcept(false)
+	: FaultInjectionBus(bus, Config())
+{
+}
+
+FaultInjectionBus::FaultInjectionBus(const shared_ptr<Bus> &bus, const Config &config) noexcept(false)
+	: _bus(bus), _stats{0, 0, 0, 0, 0}
+{
+	if (!bus) {
+		throw invalid_argument("Wrapped bus must be given.");
+	}
+
+	this->config(config);
+}
+
+uint32_t FaultInjectionBus::read32(const uint32_t addr) noexcept(false)
+{
+	Fault fault;
+
+	{
+		lock_guard<mutex> lock(this->_mtx);
+		this->_stats.readNum++;
+		fault = this->_draw(this->_config.failReadProb, this->_config.corruptReadProb);
+	}
+
+	// Delay without lock so that other threads aren't serialized by it.
+	if (fault.delay > nanoseconds::zero()) {
+		std::this_thread::sleep_for(fault.delay);
+	}
+
+	if (fault.isFail) {
+		throw range_error("Injected fault at reading bus.");
+	}
+
+	return this->_bus->read32(addr) ^ fault.corruptMask;
+}
+
+void FaultInjectionBus::write32(const uint32_t addr, const uint32_t val) noexcept(false)
+{
+	Fault fault;
+
+	{
+		lock_guard<mutex> lock(this->_mtx);
+		this->_stats.writeNum++;
+		fault = this->_draw(this->_config.failWriteProb, this->_config.corruptWriteProb);
+	}
+
+	if (fault.delay > nanoseconds::zero()) {
+		std::this_thread::sleep_for(fault.delay);
+	}
+
+	if (fault.isFail) {
+		throw range_error("Injected fault at writing bus.");
+	}
+
+	this->_bus->write32(addr, val ^ fault.corruptMask);
+}
+
+void FaultInjectionBus::config(const Config &config) noexcept(false)
+{
+	for (const double prob : {config.failReadProb, config.failWriteProb, config.corruptReadProb,
+	                          config.corruptWriteProb, config.delayProb}) {
+		if ((prob < 0.) || (prob > 1.)) {
+			throw invalid_argument("Probability must be in [0, 1].");
+		}
+	}
+
+	lock_guard<mutex> lock(this->_mtx);
+	this->_config = config;
+	this->_rng.seed(config.seed);
+}
+
+FaultInjectionBus::Config FaultInjectionBus::config() const noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_config;
+}
+
+FaultInjectionBus::Stats FaultInjectionBus::stats() const noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_stats;
+}
+
+// Private
+FaultInjectionBus::Fault FaultInjectionBus::_draw(const double failProb, const double corruptProb) noexcept(true)
+{
+	Fault ret = {nanoseconds::zero(), false, static_cast<uint32_t>(0U)};
+
+	if (this->_hit(this->_config.delayProb)) {
+		ret.delay = this->_config.delay;
+		this->_stats.delayNum++;
+	}
+
+	if (this->_hit(failProb)) {
+		ret.isFail = true;
+		this->_stats.failNum++;
+	} else if (this->_hit(corruptProb)) {
+		ret.corruptMask = static_cast<uint32_t>(1U) << (this->_rng() % static_cast<uint64_t>(32U));
+		this->_stats.corruptNum++;
+	}
+
+	return ret;
+}
+
+bool FaultInjectionBus::_hit(const double prob) noexcept(true)
+{
+	// Don't consume random numbers for disabled faults, so a seed reproduces the same faults.
+	if (prob <= 0.) {
+		return false;
+	}
+
+	return std::generate_canonical<double, 53>(this->_rng) < prob;
+}
+
+} // End of "namespace bldcm"
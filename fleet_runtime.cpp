@@ -0,0 +1,376 @@
+#include <libbldcm/fleet_runtime.hpp>
+#include <libbldcm.hpp>
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <sched.h>
+
+using std::unique_ptr;
+using std::make_unique;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::out_of_range;
+using std::invalid_argument;
+using std::runtime_error;
+using std::chrono::nanoseconds;
+using std::chrono::duration_cast;
+
+namespace bldcm {
+
+//========  FleetRuntime class ========
+// Public
+FleetRuntime::FleetRuntime(const std::size_t workerNum, const bool isPinned) noexcept(false)
+	: _isStopRequested(false), _migratedUnitNum(0), _migratedTaskNum(0), _taskErrorNum(0)
+{
+	const unsigned int cpuNum = std::max(std::thread::hardware_concurrency(), 1U);
+
+	if (workerNum == 0) {
+		throw invalid_argument("The number of workers must be positive.");
+	}
+
+	for (std::size_t i = 0; i < workerNum; i++) {
+		auto worker = make_unique<Worker>();
+
+		worker->cpu = (isPinned) ? static_cast<int>(i % cpuNum) : -1;
+		worker->busyNs.store(0);
+		worker->taskRunNum.store(0);
+		worker->stealNum.store(0);
+		worker->wakeNum = 0;
+		this->_workers.push_back(std::move(worker));
+	}
+}
+
+FleetRuntime::~FleetRuntime()
+{
+	this->stop();
+}
+
+std::size_t FleetRuntime::add(unique_ptr<Motor> &&motor) noexcept(false)
+{
+	auto unit = make_unique<Unit>();
+	Worker *owner = nullptr;
+	std::size_t id;
+
+	unit->motor = std::move(motor);
+	unit->nextDue.store(Clock::time_point::max().time_since_epoch().count());
+
+	{
+		lock_guard<mutex> lock(this->_unitsMtx);
+		id = this->_units.size();
+		this->_units.push_back(std::move(unit));
+	}
+
+	for (auto &worker : this->_workers) {
+		lock_guard<mutex> lock(worker->mtx);
+		if ((owner == nullptr) || (worker->units.size() < owner->units.size())) {
+			owner = worker.get();
+		}
+	}
+
+	{
+		lock_guard<mutex> lock(owner->mtx);
+		owner->units.push_back(&this->_unit(id));
+	}
+
+	return id;
+}
+
+void FleetRuntime::schedule(const std::size_t id, const Task &task, const nanoseconds &period) noexcept(false)
+{
+	Unit &unit = this->_unit(id);
+
+	if (period <= nanoseconds::zero()) {
+		throw invalid_argument("Period of task must be positive.");
+	}
+
+	{
+		lock_guard<mutex> lock(unit.mtx);
+		const Clock::time_point now = Clock::now();
+
+		unit.tasks.push_back(ScheduledTask{task, period, now});
+		unit.nextDue.store(std::min(unit.nextDue.load(), now.time_since_epoch().count()));
+	}
+
+	this->_wake();
+}
+
+void FleetRuntime::post(const std::size_t id, const Task &task) noexcept(false)
+{
+	Unit &unit = this->_unit(id);
+
+	{
+		lock_guard<mutex> lock(unit.mtx);
+		const Clock::time_point now = Clock::now();
+
+		unit.tasks.push_back(ScheduledTask{task, nanoseconds::zero(), now});
+		unit.nextDue.store(std::min(unit.nextDue.load(), now.time_since_epoch().count()));
+	}
+
+	this->_wake();
+}
+
+void FleetRuntime::start() noexcept(false)
+{
+	if (this->_workers.front()->thread.joinable()) {
+		return;
+	}
+
+	this->_isStopRequested.store(false);
+	this->_startTime = Clock::now();
+
+	for (std::size_t i = 0; i < this->_workers.size(); i++) {
+		Worker &worker = *this->_workers[i];
+
+		worker.busyNs.store(0);
+		worker.thread = std::thread(&FleetRuntime::_run, this, i);
+
+		if (worker.cpu >= 0) {
+			cpu_set_t cpuSet;
+			CPU_ZERO(&cpuSet);
+			CPU_SET(worker.cpu, &cpuSet);
+			// Failure of pinning isn't fatal. The worker runs on any CPU.
+			static_cast<void>(pthread_setaffinity_np(worker.thread.native_handle(), sizeof(cpuSet), &cpuSet));
+		}
+	}
+}
+
+void FleetRuntime::stop() noexcept(true)
+{
+	this->_isStopRequested.store(true);
+
+	for (auto &worker : this->_workers) {
+		{
+			lock_guard<mutex> lock(worker->mtx);
+		}
+		worker->cv.notify_all();
+	}
+
+	for (auto &worker : this->_workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+}
+
+FleetRuntime::Stats FleetRuntime::stats() const noexcept(false)
+{
+	Stats ret;
+	const double elapsedNs = static_cast<double>(duration_cast<nanoseconds>(Clock::now() - this->_startTime).count());
+
+	for (const auto &worker : this->_workers) {
+		WorkerStats ws;
+
+		ws.cpu         = worker->cpu;
+		ws.utilization = (elapsedNs > 0.) ? (static_cast<double>(worker->busyNs.load()) / elapsedNs) : 0.;
+		ws.taskRunNum  = worker->taskRunNum.load();
+		ws.stealNum    = worker->stealNum.load();
+		{
+			lock_guard<mutex> lock(worker->mtx);
+			ws.unitNum = worker->units.size();
+		}
+		ret.workers.push_back(ws);
+	}
+
+	ret.migratedUnitNum = this->_migratedUnitNum.load();
+	ret.migratedTaskNum = this->_migratedTaskNum.load();
+	ret.taskErrorNum    = this->_taskErrorNum.load();
+
+	return ret;
+}
+
+// Private
+void FleetRuntime::_run(const std::size_t idx) noexcept(true)
+{
+	Worker &worker = *this->_workers[idx];
+
+	while (!this->_isStopRequested.load()) {
+		std::size_t num;
+		uint64_t    wakeNum;
+		Clock::rep  earliest = Clock::time_point::max().time_since_epoch().count();
+
+		{
+			lock_guard<mutex> lock(worker.mtx);
+			num = worker.units.size();
+		}
+
+		// A unit being run is out of the deque, so it's never stolen while running.
+		for (std::size_t i = 0; i < num; i++) {
+			Unit *unit;
+
+			{
+				lock_guard<mutex> lock(worker.mtx);
+				if (worker.units.empty()) {
+					break;
+				}
+				unit = worker.units.front();
+				worker.units.pop_front();
+			}
+
+			if (unit->nextDue.load() <= Clock::now().time_since_epoch().count()) {
+				this->_runUnit(*unit, worker);
+			}
+
+			{
+				lock_guard<mutex> lock(worker.mtx);
+				worker.units.push_back(unit);
+			}
+		}
+
+		{
+			lock_guard<mutex> lock(worker.mtx);
+			// Tasks posted after this are noticed by the change of wakeNum, even before waiting.
+			wakeNum = worker.wakeNum;
+			for (const Unit *unit : worker.units) {
+				earliest = std::min(earliest, unit->nextDue.load());
+			}
+		}
+
+		const Clock::time_point now  = Clock::now();
+		const Clock::time_point next = Clock::time_point(Clock::duration(earliest));
+
+		if (next > now) {
+			if (this->_steal(idx)) {
+				continue;
+			}
+
+			unique_lock<mutex> lock(worker.mtx);
+			worker.cv.wait_until(lock, std::min(next, now + _MaxIdle), [this, &worker, wakeNum] {
+				return this->_isStopRequested.load() || (worker.wakeNum != wakeNum);
+			});
+		}
+	}
+}
+
+void FleetRuntime::_runUnit(Unit &unit, Worker &worker) noexcept(true)
+{
+	auto &running = unit.running;
+	const Clock::time_point begin = Clock::now();
+	Clock::rep nextDue = Clock::time_point::max().time_since_epoch().count();
+
+	// Take the tasks out, so that they can post or schedule to this unit while running.
+	{
+		lock_guard<mutex> lock(unit.mtx);
+		running.swap(unit.tasks);
+	}
+
+	for (auto itr = running.begin(); itr != running.end();) {
+		if (itr->next <= begin) {
+			try {
+				itr->task(*unit.motor);
+			} catch (...) {
+				this->_taskErrorNum++;
+			}
+			worker.taskRunNum++;
+
+			if (itr->period == nanoseconds::zero()) {
+				itr = running.erase(itr);
+				continue;
+			}
+
+			itr->next += itr->period;
+			if (itr->next < begin) {
+				// Skip missed periods instead of bursting.
+				itr->next = begin + itr->period;
+			}
+		}
+
+		nextDue = std::min(nextDue, itr->next.time_since_epoch().count());
+		++itr;
+	}
+
+	{
+		// Tasks added while running are queued after the existing ones.
+		lock_guard<mutex> lock(unit.mtx);
+
+		for (const ScheduledTask &task : unit.tasks) {
+			nextDue = std::min(nextDue, task.next.time_since_epoch().count());
+		}
+		running.insert(running.end(), std::make_move_iterator(unit.tasks.begin()), std::make_move_iterator(unit.tasks.end()));
+		unit.tasks.clear();
+		running.swap(unit.tasks);
+		unit.nextDue.store(nextDue);
+	}
+
+	worker.busyNs += static_cast<uint64_t>(duration_cast<nanoseconds>(Clock::now() - begin).count());
+}
+
+bool FleetRuntime::_steal(const std::size_t idx) noexcept(true)
+{
+	const Clock::rep threshold = (Clock::now() - _StealLag).time_since_epoch().count();
+	Worker &thief = *this->_workers[idx];
+
+	for (std::size_t i = 1; i < this->_workers.size(); i++) {
+		Worker &victim = *this->_workers[(idx + i) % this->_workers.size()];
+		Unit *stolen = nullptr;
+
+		{
+			lock_guard<mutex> lock(victim.mtx);
+
+			// The victim keeps at least one unit.
+			if (victim.units.size() <= 1) {
+				continue;
+			}
+
+			for (auto itr = victim.units.rbegin(); itr != victim.units.rend(); ++itr) {
+				if ((*itr)->nextDue.load() <= threshold) {
+					stolen = *itr;
+					victim.units.erase(std::next(itr).base());
+					break;
+				}
+			}
+		}
+
+		if (stolen != nullptr) {
+			{
+				lock_guard<mutex> lock(stolen->mtx);
+				this->_migratedTaskNum += stolen->tasks.size();
+			}
+			{
+				lock_guard<mutex> lock(thief.mtx);
+				thief.units.push_back(stolen);
+			}
+			this->_migratedUnitNum++;
+			thief.stealNum++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FleetRuntime::Unit &FleetRuntime::_unit(const std::size_t id) const noexcept(false)
+{
+	lock_guard<mutex> lock(this->_unitsMtx);
+
+	if (id >= this->_units.size()) {
+		throw out_of_range("Unit ID is out of range.");
+	}
+
+	return *this->_units[id];
+}
+
+void FleetRuntime::_wake() noexcept(true)
+{
+	// Owner of the unit may change by stealing, so all workers are woken.
+	for (auto &worker : this->_workers) {
+		{
+			// Update under the lock not to lose the wake up of a worker going to wait.
+			lock_guard<mutex> lock(worker->mtx);
+			worker->wakeNum++;
+		}
+		worker->cv.notify_all();
+	}
+}
+
+} // End of "namespace bldcm"
+
@@ -1,7 +1,10 @@
 #ifndef LIBBLDCM_HPP
 #define LIBBLDCM_HPP
 
+#include <libbldcm/types.hpp>
+#include <libbldcm/bus.hpp>
 #include <libbldcm/register_map.hpp>
+#include <libbldcm/shadow_store.hpp>
 
 #include <libfpgasoc.hpp>
 #include <memory>
@@ -19,31 +22,24 @@
 
 namespace bldcm {
 
-// Types
-using Rps = std::chrono::duration< int64_t, std::ratio<1> >;
-using Rpm = std::chrono::duration< int64_t, std::ratio<1, 60> >;
-
-template<typename RSConverted, typename RSBase>
-constexpr RSConverted rotationalSpeed_cast(const RSBase &rs)
-{
-	return std::chrono::duration_cast<RSConverted>(rs);
-}
-
-using Hz  = std::chrono::duration< int64_t, std::ratio<1> >;
-using KHz = std::chrono::duration< int64_t, std::ratio<1000> >;
-using MHz = std::chrono::duration< int64_t, std::ratio<1000000> >;
-
-template<typename ClkFqConverted, typename ClkFqBase>
-constexpr ClkFqConverted clockFreq_cast(const ClkFqBase &clkFq)
-{
-	return std::chrono::duration_cast<ClkFqConverted>(clkFq);
-}
+class LatencyProfiler;
 
 class Motor {
 	public:
+		// Type define
+		struct Status {
+			bool isStopping;
+			bool isReflectedFreq;
+		};
+
 		// Constructor/destructor
+		// If shadowStore is given, caches are persisted on it and the motor is resumed from it if possible.
 		template<typename ClkFqType>
-		Motor(const std::shared_ptr<Fpgasoc> &ptr, const ClkFqType &clkFq, const uint32_t baseAddr);
+		Motor(const std::shared_ptr<Fpgasoc> &ptr, const ClkFqType &clkFq, const uint32_t baseAddr,
+		      const std::shared_ptr<ShadowStore> &shadowStore = nullptr);
+		template<typename ClkFqType>
+		Motor(const std::shared_ptr<Bus> &ptr, const ClkFqType &clkFq, const uint32_t baseAddr,
+		      const std::shared_ptr<ShadowStore> &shadowStore = nullptr);
 		~Motor() {}
 
 		// Methods
@@ -57,11 +53,14 @@ class Motor {
 
 		void outputEnable(bool isEnable) noexcept(false);
 		bool outputEnable() noexcept(false);
+		bool outputEnable(const std::chrono::nanoseconds &maxAge) noexcept(false); // Cache is used if fresh enough.
 
 		template<typename PeriodType> // PeriodType is nanoseconds, microseconds, milliseconds, or seconds.
 		void pwmPeriod(const PeriodType &period, const int prsc) noexcept(false);
 		template<typename PeriodType>
 		std::pair<PeriodType, int> pwmPeriod() noexcept(false);
+		template<typename PeriodType>
+		std::pair<PeriodType, int> pwmPeriod(const std::chrono::nanoseconds &maxAge) noexcept(false);
 
 		void phase(const int phase) noexcept(false);
 		int phase() noexcept(false);
@@ -71,6 +70,31 @@ class Motor {
 
 		bool isReflectedFreq() noexcept(false);
 		bool isStopping() noexcept(false);
+		Status status() noexcept(false); // Read STAT only once.
+
+		bool isReflectedFreq(const std::chrono::nanoseconds &maxAge) noexcept(false);
+		bool isStopping(const std::chrono::nanoseconds &maxAge) noexcept(false);
+		Status status(const std::chrono::nanoseconds &maxAge) noexcept(false);
+
+		// Cache statistics of the getters with max age.
+		const Register &ctrlReg() const noexcept(true);
+		const Register &statReg() const noexcept(true);
+
+		bool isResumed() const noexcept(true); // Whether constructed by resuming from shadow store.
+
+		// Policy of retrying failed bus accesses of all registers. Default is Register::NoRetry.
+		void retryPolicy(const Register::RetryPolicy &policy) noexcept(true);
+
+		// While profiler is attached, setters wait for the transition of STAT and record its latency.
+		// They block for up to the timeout of the profiler, so don't profile motors used by Watchdog or MotorDaemon.
+		void profiler(const std::shared_ptr<LatencyProfiler> &profiler) noexcept(true);
+		uint32_t baseAddr() const noexcept(true);
+
+		// Registers for drivers writing them directly. Writes through them bypass the setters,
+		// so cached values of Motor like PWM duty aren't updated.
+		RegMap &regMap() noexcept(true);
+		// Record PWM duty applied through regMap() so that pwmDuty() and the shadow store follow it.
+		void pwmDutyCache(const int duty) noexcept(true);
 
 	private:
 		// Materials
@@ -92,14 +116,28 @@ class Motor {
 		std::pair<bool, std::string> _hwIpVersion = std::make_pair(false, _InvalidHwIpVerStr);
 		std::pair<bool, int>         _deadtime    = std::make_pair(false, _InvalidDeadtime);
 		std::pair<bool, int>         _pwmDuty     = std::make_pair(false, _InvalidPwmDuty);
+		std::shared_ptr<ShadowStore> _shadowStore;
+		ShadowStore::Slot           *_shadowSlot = nullptr;
+		bool                         _isResumed  = false;
+		std::shared_ptr<LatencyProfiler> _profiler;
 
 		// Methods
 		void _fetchHwIpVersion(const bool fromCache) noexcept(true);
 		void _fetchDeadtime(const bool fromCache) noexcept(true);
 		void _calcPwmDutyFromRegister() noexcept(true);
+		template<typename PeriodType>
+		std::pair<PeriodType, int> _pwmPeriodFromCache() noexcept(false);
+		bool _resumeFromShadow() noexcept(true);
+		void _storeToShadow() noexcept(true);
 };
 
 } // End of "namespace bldcm"
 
+#ifdef LIBBLDCM_HEADER_ONLY
+#include <libbldcm/latency_profiler.hpp>
+#include <libbldcm/impl/motor_impl.hpp>
+#include <libbldcm/impl/latency_profiler_impl.hpp>
+#endif
+
 #endif // End of "#ifndef LIBBLDCM_HPP"
 
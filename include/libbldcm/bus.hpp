@@ -0,0 +1,46 @@
+#ifndef BUS_HPP
+#define BUS_HPP
+
+#include <libfpgasoc.hpp>
+
+#include <cstdint>
+#include <memory>
+
+namespace bldcm {
+// Backend to access registers of mBldcm.
+class Bus {
+	public:
+		// Constructor/Destructor
+		virtual ~Bus() {}
+
+		// Methods
+		virtual uint32_t read32(const uint32_t addr) noexcept(false) = 0;
+		virtual void write32(const uint32_t addr, const uint32_t val) noexcept(false) = 0;
+};
+
+// Backend accessing real HW via libfpgasoc.
+class FpgasocBus : public Bus {
+	public:
+		// Constructor/Destructor
+		explicit FpgasocBus(const std::shared_ptr<Fpgasoc> &ptr)
+			: _fpgaObjPtr(ptr) {}
+		~FpgasocBus() override {}
+
+		// Methods
+		uint32_t read32(const uint32_t addr) noexcept(false) override
+		{
+			return this->_fpgaObjPtr->read32(addr);
+		}
+
+		void write32(const uint32_t addr, const uint32_t val) noexcept(false) override
+		{
+			this->_fpgaObjPtr->write32(addr, val);
+		}
+
+	private:
+		std::shared_ptr<Fpgasoc> _fpgaObjPtr;
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef BUS_HPP"
+
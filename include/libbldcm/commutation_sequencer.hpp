@@ -0,0 +1,83 @@
+#ifndef COMMUTATION_SEQUENCER_HPP
+#define COMMUTATION_SEQUENCER_HPP
+
+#include <libbldcm.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+
+namespace bldcm {
+// Software commutation stepping CTRL.PHASE along a timetable on a timed thread.
+// CTRL words of all phases are precomputed, so each step is exactly one register write.
+// While the sequence is running, CTRL of the motor must not be accessed from other threads.
+class CommutationSequencer {
+	public:
+		// Type define
+		enum class Direction {
+			forward, // 0, 1, ..., 5, 0, ...
+			reverse  // 5, 4, ..., 0, 5, ...
+		};
+
+		struct Stats {
+			uint64_t stepNum;
+			std::chrono::nanoseconds minError; // Error of the time of each write against the timetable.
+			std::chrono::nanoseconds maxError;
+			std::chrono::nanoseconds totalAbsError;
+		};
+
+		// Constructor/Destructor
+		explicit CommutationSequencer(Motor &motor) noexcept(false);
+		~CommutationSequencer();
+
+		CommutationSequencer(const CommutationSequencer &) = delete;
+		CommutationSequencer &operator=(const CommutationSequencer &) = delete;
+
+		// Methods
+		void prepare() noexcept(false); // Precompute CTRL words again. Call it after changing other fields of CTRL.
+
+		// Each entry of timetable is the interval from the previous step (or start) to the step.
+		void start(const std::vector<std::chrono::nanoseconds> &timetable, const Direction dir = Direction::forward) noexcept(false);
+		void stop() noexcept(true);
+		void wait() noexcept(false); // Wait for the end of sequence. Exception in the sequence is rethrown.
+		bool isRunning() const noexcept(true);
+
+		void spinMargin(const std::chrono::nanoseconds &margin) noexcept(true); // Busy wait before each step.
+		Stats stats() const noexcept(true); // Updated at every step.
+
+		// Timetable accelerating linearly in speed from startInterval to endInterval.
+		static std::vector<std::chrono::nanoseconds> accelerationTable(const std::chrono::nanoseconds &startInterval,
+		                                                               const std::chrono::nanoseconds &endInterval,
+		                                                               const std::size_t stepNum) noexcept(false);
+
+	private:
+		// Materials
+		static constexpr std::size_t _PhaseNum = static_cast<std::size_t>(6U);
+
+		// Members
+		Motor                              &_motor;
+		std::array<uint32_t, _PhaseNum>     _ctrlWords;
+		int                                 _phase;
+		std::thread                         _thread;
+		std::atomic<bool>                   _isRunning;
+		std::atomic<bool>                   _isStopRequested;
+		std::chrono::nanoseconds            _spinMargin;
+		mutable std::mutex                  _mtx;
+		std::condition_variable             _cv; // Wake up the sequence thread at stop().
+		Stats                               _stats;
+		std::exception_ptr                  _exception;
+
+		// Methods
+		void _run(const std::vector<std::chrono::nanoseconds> timetable, const Direction dir) noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef COMMUTATION_SEQUENCER_HPP"
+
@@ -0,0 +1,13 @@
+#ifndef LIBBLDCM_CONFIG_HPP
+#define LIBBLDCM_CONFIG_HPP
+
+// With LIBBLDCM_HEADER_ONLY, definitions in include/libbldcm/impl are included by headers
+// and non-template functions become inline. Otherwise, they are compiled into bldcm library.
+#ifdef LIBBLDCM_HEADER_ONLY
+#define LIBBLDCM_INLINE inline
+#else
+#define LIBBLDCM_INLINE
+#endif
+
+#endif // End of "#ifndef LIBBLDCM_CONFIG_HPP"
+
@@ -0,0 +1,277 @@
+#ifndef CORO_HPP
+#define CORO_HPP
+
+#if (__cplusplus < 202002L) || (!defined(__cpp_impl_coroutine))
+#error "Coroutine layer of libbldcm requres C++20 or higher."
+#endif
+
+#include <libbldcm.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <type_traits>
+#include <functional>
+#include <vector>
+#include <queue>
+#include <unordered_set>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <stdexcept>
+
+namespace bldcm::coro {
+
+// Lazy coroutine. It starts when awaited or spawned on EventLoop.
+template<typename T>
+class Task;
+
+namespace detail {
+template<typename Promise>
+struct FinalAwaiter {
+	bool await_ready() const noexcept { return false; }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+	{
+		const std::coroutine_handle<> cont = h.promise().continuation;
+		return (cont) ? cont : std::noop_coroutine();
+	}
+	void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+	std::coroutine_handle<> continuation;
+	std::exception_ptr      exception;
+
+	std::suspend_always initial_suspend() const noexcept { return {}; }
+	void unhandled_exception() noexcept { this->exception = std::current_exception(); }
+};
+} // End of "namespace detail"
+
+template<typename T>
+class Task {
+	public:
+		// Type define
+		struct promise_type : detail::PromiseBase {
+			std::optional<T> value;
+
+			Task get_return_object() noexcept { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			detail::FinalAwaiter<promise_type> final_suspend() const noexcept { return {}; }
+			void return_value(T val) noexcept(std::is_nothrow_move_constructible_v<T>) { this->value.emplace(std::move(val)); }
+		};
+
+		// Constructor/Destructor
+		Task(Task &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+		Task &operator=(Task &&other) noexcept
+		{
+			if (this != &other) {
+				this->_destroy();
+				this->_handle = std::exchange(other._handle, nullptr);
+			}
+			return *this;
+		}
+		~Task() { this->_destroy(); }
+
+		Task(const Task &) = delete;
+		Task &operator=(const Task &) = delete;
+
+		// Awaiter
+		bool await_ready() const noexcept { return false; }
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> cont) noexcept
+		{
+			this->_handle.promise().continuation = cont;
+			return this->_handle;
+		}
+		T await_resume()
+		{
+			promise_type &p = this->_handle.promise();
+			if (p.exception) {
+				std::rethrow_exception(p.exception);
+			}
+			return std::move(*p.value);
+		}
+
+	private:
+		explicit Task(std::coroutine_handle<promise_type> h) noexcept : _handle(h) {}
+		void _destroy() noexcept
+		{
+			if (this->_handle) {
+				this->_handle.destroy();
+			}
+		}
+
+		std::coroutine_handle<promise_type> _handle;
+};
+
+template<>
+class Task<void> {
+	public:
+		// Type define
+		struct promise_type : detail::PromiseBase {
+			Task get_return_object() noexcept { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			detail::FinalAwaiter<promise_type> final_suspend() const noexcept { return {}; }
+			void return_void() const noexcept {}
+		};
+
+		// Constructor/Destructor
+		Task(Task &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+		Task &operator=(Task &&other) noexcept
+		{
+			if (this != &other) {
+				this->_destroy();
+				this->_handle = std::exchange(other._handle, nullptr);
+			}
+			return *this;
+		}
+		~Task() { this->_destroy(); }
+
+		Task(const Task &) = delete;
+		Task &operator=(const Task &) = delete;
+
+		// Awaiter
+		bool await_ready() const noexcept { return false; }
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> cont) noexcept
+		{
+			this->_handle.promise().continuation = cont;
+			return this->_handle;
+		}
+		void await_resume()
+		{
+			promise_type &p = this->_handle.promise();
+			if (p.exception) {
+				std::rethrow_exception(p.exception);
+			}
+		}
+
+	private:
+		explicit Task(std::coroutine_handle<promise_type> h) noexcept : _handle(h) {}
+		void _destroy() noexcept
+		{
+			if (this->_handle) {
+				this->_handle.destroy();
+			}
+		}
+
+		std::coroutine_handle<promise_type> _handle;
+};
+
+// Single-threaded event loop built on epoll and timerfd.
+// All pending waits share one timerfd, so thousands of them cost only one thread.
+class EventLoop {
+	public:
+		// Type define
+		using Clock = std::chrono::steady_clock;
+
+		class SleepAwaiter {
+			public:
+				SleepAwaiter(EventLoop &loop, const Clock::time_point &time) noexcept : _loop(loop), _time(time) {}
+				bool await_ready() const noexcept { return false; }
+				void await_suspend(std::coroutine_handle<> h) { this->_loop._schedule(this->_time, h); }
+				void await_resume() const noexcept {}
+
+			private:
+				EventLoop        &_loop;
+				Clock::time_point _time;
+		};
+
+		// Constructor/Destructor
+		EventLoop() noexcept(false);
+		~EventLoop();
+
+		EventLoop(const EventLoop &) = delete;
+		EventLoop &operator=(const EventLoop &) = delete;
+
+		// Methods
+		void spawn(Task<void> &&task) noexcept(false); // Start task detached from caller.
+		// Run until all spawned tasks finish or stop() is called. Unfinished tasks are destroyed with the loop.
+		void run() noexcept(false);
+		void stop() noexcept(true);  // It can be called from any thread.
+
+		SleepAwaiter sleepFor(const std::chrono::nanoseconds &duration) noexcept(true);
+		SleepAwaiter sleepUntil(const Clock::time_point &time) noexcept(true);
+
+		std::size_t pendingNum() const noexcept(true); // Number of pending waits.
+
+	private:
+		// Type define
+		struct Timer {
+			Clock::time_point       time;
+			uint64_t                seq; // Keep FIFO order of timers which have the same time.
+			std::coroutine_handle<> handle;
+
+			bool operator>(const Timer &other) const noexcept
+			{
+				return (this->time != other.time) ? (this->time > other.time) : (this->seq > other.seq);
+			}
+		};
+
+		struct Detached;
+
+		// Members
+		int _epollFd;
+		int _timerFd;
+		int _wakeFd;
+		std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> _timers;
+		std::vector<std::coroutine_handle<>> _expired;
+		std::unordered_set<void *> _detached; // Frames of spawned tasks not finished yet.
+		uint64_t           _timerSeq = 0;
+		std::atomic<bool>  _isStopRequested{false};
+		std::exception_ptr _exception;
+		Clock::time_point  _armedTime = Clock::time_point::max();
+
+		// Methods
+		void _schedule(const Clock::time_point &time, std::coroutine_handle<> h) noexcept(false);
+		void _armTimer() noexcept(false);
+		static Detached _runDetached(EventLoop &loop, Task<void> task);
+};
+
+// Awaitables for motors. Motor must be used only on the thread running the loop.
+inline constexpr std::chrono::nanoseconds DefaultPollPeriod = std::chrono::milliseconds(1);
+
+Task<void> untilStopped(EventLoop &loop, Motor &motor,
+                        const std::chrono::nanoseconds pollPeriod = DefaultPollPeriod);
+// Return false if STAT.REFLECTEDFREQ isn't asserted until timeout.
+Task<bool> untilReflected(EventLoop &loop, Motor &motor, const std::chrono::nanoseconds timeout,
+                          const std::chrono::nanoseconds pollPeriod = DefaultPollPeriod);
+
+namespace detail {
+template<typename RotationalSpeedType>
+Task<void> ramp(EventLoop &loop, Motor &motor, const RotationalSpeedType target,
+                const RotationalSpeedType step, const std::chrono::nanoseconds interval)
+{
+	RotationalSpeedType speed = motor.rotationalSpeed<RotationalSpeedType>();
+	const RotationalSpeedType absStep = (step < RotationalSpeedType::zero()) ? -step : step;
+
+	while (speed != target) {
+		if (speed < target) {
+			speed = ((target - speed) > absStep) ? (speed + absStep) : target;
+		} else {
+			speed = ((speed - target) > absStep) ? (speed - absStep) : target;
+		}
+
+		motor.rotationalSpeed(speed);
+
+		if (speed != target) {
+			co_await loop.sleepFor(interval);
+		}
+	}
+}
+} // End of "namespace detail"
+
+// Change rotational speed to target step by step. RotationalSpeedType is Rps or Rpm.
+// Zero step is rejected at the call, because the ramp would never reach the target.
+template<typename RotationalSpeedType>
+Task<void> ramp(EventLoop &loop, Motor &motor, const RotationalSpeedType target,
+                const RotationalSpeedType step, const std::chrono::nanoseconds interval)
+{
+	if (step == RotationalSpeedType::zero()) {
+		throw std::invalid_argument("Step of ramp must not be zero.");
+	}
+
+	return detail::ramp(loop, motor, target, step, interval);
+}
+
+} // End of "namespace bldcm::coro"
+
+#endif // End of "#ifndef CORO_HPP"
+
@@ -0,0 +1,83 @@
+#ifndef DUTY_DITHER_HPP
+#define DUTY_DITHER_HPP
+
+#include <libbldcm.hpp>
+
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+namespace bldcm {
+// Sigma-delta dithering of PWM_CMP for finer effective duty than one count of PWM_CMP.
+// PWM_CMP toggles between neighbouring compare values so that its average approaches the target.
+// Each update of a motor costs a few integer operations and at most one register write.
+// PWM_CMP of added motors is owned by this, so Motor::pwmDuty(int) and Motor::pwmPeriod() must not be used for them.
+// Use DutyDither::pwmPeriod() instead, which changes the period under the lock of the dithering thread.
+class DutyDither {
+	public:
+		// Type define
+		struct Stats {
+			uint64_t passNum;
+			uint64_t writeNum;
+			std::chrono::nanoseconds maxPassTime;
+		};
+
+		// Constructor/Destructor
+		explicit DutyDither(const std::chrono::nanoseconds &updatePeriod) noexcept(false);
+		~DutyDither();
+
+		DutyDither(const DutyDither &) = delete;
+		DutyDither &operator=(const DutyDither &) = delete;
+
+		// Methods
+		void add(Motor &motor) noexcept(false);
+		void remove(const Motor &motor) noexcept(true);
+		// Set target duty [%]. PWM_CMP is written at the next update even if it seems unchanged.
+		void duty(Motor &motor, const double duty) noexcept(false);
+		// Change PWM period of the motor and keep the target duty for new PWM_MAXCNT.
+		void pwmPeriod(Motor &motor, const std::chrono::nanoseconds &period, const int prsc) noexcept(false);
+
+		void start() noexcept(false);
+		void stop() noexcept(true);
+		void update() noexcept(true); // Run one pass on caller's thread.
+
+		Stats stats() noexcept(false);
+
+	private:
+		// Type define
+		struct Entry {
+			Motor   *motor;
+			uint32_t baseCmp;  // Integer part of target compare value
+			uint32_t fraction; // Fractional part of target compare value in _FracBits bits
+			uint32_t acc;      // Error accumulator of sigma-delta modulation
+			uint32_t lastCmp;  // Last written value, or _InvalidCmp to force writing
+			double   target;   // Target duty [%]. Negative until duty() is called.
+		};
+
+		// Materials
+		static constexpr uint32_t _FracBits = static_cast<uint32_t>(16U);
+		static constexpr uint32_t _FracMask = (static_cast<uint32_t>(1U) << _FracBits) - static_cast<uint32_t>(1U);
+		static constexpr uint32_t _InvalidCmp = static_cast<uint32_t>(0xFFFFFFFFU);
+
+		// Members
+		const std::chrono::nanoseconds _updatePeriod;
+		std::vector<Entry>             _entries;
+		std::mutex                     _mtx;
+		std::condition_variable        _cv;
+		std::thread                    _thread;
+		bool                           _isStopRequested;
+		Stats                          _stats;
+
+		// Methods
+		void _run() noexcept(true);
+		void _updateLocked() noexcept(true);
+		static void _dutyLocked(Entry &entry, const double duty) noexcept(false);
+		Entry *_find(const Motor &motor) noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef DUTY_DITHER_HPP"
+
@@ -0,0 +1,74 @@
+#ifndef EMERGENCY_STOP_HPP
+#define EMERGENCY_STOP_HPP
+
+#include <libbldcm.hpp>
+#include <libbldcm/bus.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+namespace bldcm {
+// Emergency stop disabling output of all added motors with back-to-back writes of CTRL.
+// Disabled CTRL word of each motor is precomputed, so trigger() bypasses register caches, their states
+// and command queues. trigger() itself doesn't allocate nor lock, and it can be called from any thread concurrently.
+// It's async-signal-safe only if Bus::write32() of the backends neither locks nor throws, like a plain store to
+// memory mapped registers. SimBus and FaultInjectionBus lock mutex, so they must not be used from signal handler.
+// Register caches of CTRL are stale after trigger() until resync() is called.
+// Users writing CTRL by themselves like CommutationSequencer must be stopped not to enable output again.
+class EmergencyStop {
+	public:
+		// Constructor/Destructor
+		explicit EmergencyStop(const std::size_t capacity = DefaultCapacity) noexcept(false);
+		~EmergencyStop() {}
+
+		EmergencyStop(const EmergencyStop &) = delete;
+		EmergencyStop &operator=(const EmergencyStop &) = delete;
+
+		// Methods
+		// Entry of the same CTRL register is reused. Throw if CTRL of the motor has uncommitted modification.
+		void add(Motor &motor) noexcept(false);
+		void remove(const Motor &motor) noexcept(true);
+		// Recompute disabled CTRL words from caches. Call it after changing PWM period or phase.
+		void refresh() noexcept(false);
+
+		// Return total time of disabling. Concurrent or nested calls write the same words again.
+		std::chrono::nanoseconds trigger() noexcept(true);
+		// Read CTRL of all motors to synchronize their caches after trigger().
+		void resync() noexcept(false);
+
+		uint64_t triggerNum() const noexcept(true);
+		uint64_t lastFailNum() const noexcept(true); // Number of failed writes at the last trigger.
+
+		// Materials
+		static constexpr std::size_t DefaultCapacity = 256;
+
+	private:
+		// Type define
+		// Entries are only appended and deactivated, so trigger() can read them without lock.
+		struct Entry {
+			Motor                *motor;
+			std::shared_ptr<Bus>  bus;
+			uint32_t              addr;
+			std::atomic<uint32_t> word;
+			std::atomic<bool>     isActive;
+		};
+
+		// Members
+		const std::size_t         _capacity;
+		std::unique_ptr<Entry[]>  _entries;
+		std::atomic<std::size_t>  _entryNum;
+		std::mutex                _mtx; // Used except trigger().
+		std::atomic<uint64_t>     _triggerNum;
+		std::atomic<uint64_t>     _lastFailNum;
+
+		// Methods
+		static uint32_t _disabledWord(Motor &motor) noexcept(false);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef EMERGENCY_STOP_HPP"
+
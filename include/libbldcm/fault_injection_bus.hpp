@@ -0,0 +1,72 @@
+#ifndef FAULT_INJECTION_BUS_HPP
+#define FAULT_INJECTION_BUS_HPP
+
+#include <libbldcm/bus.hpp>
+
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+
+namespace bldcm {
+// Backend wrapping another backend to inject faults of bus accesses.
+// Failed accesses throw std::range_error like unaligned accesses of libfpgasoc.
+// Delay is injected before the access, and corruption flips one random bit of the value read or written.
+class FaultInjectionBus : public Bus {
+	public:
+		// Type define
+		struct Config {
+			double failReadProb     = 0.; // Probability of each fault in [0, 1]
+			double failWriteProb    = 0.;
+			double corruptReadProb  = 0.;
+			double corruptWriteProb = 0.;
+			double delayProb        = 0.;
+			std::chrono::nanoseconds delay = std::chrono::nanoseconds(0);
+			uint64_t seed = 0;
+		};
+
+		struct Stats {
+			uint64_t readNum;
+			uint64_t writeNum;
+			uint64_t failNum;
+			uint64_t corruptNum;
+			uint64_t delayNum;
+		};
+
+		// Constructor/Destructor
+		explicit FaultInjectionBus(const std::shared_ptr<Bus> &bus) noexcept(false);
+		FaultInjectionBus(const std::shared_ptr<Bus> &bus, const Config &config) noexcept(false);
+		~FaultInjectionBus() override {}
+
+		// Methods
+		uint32_t read32(const uint32_t addr) noexcept(false) override;
+		void write32(const uint32_t addr, const uint32_t val) noexcept(false) override;
+
+		void config(const Config &config) noexcept(false); // Reseed and change probabilities.
+		Config config() const noexcept(false);
+		Stats stats() const noexcept(false);
+
+	private:
+		// Type define
+		struct Fault {
+			std::chrono::nanoseconds delay;
+			bool                     isFail;
+			uint32_t                 corruptMask; // XORed to the value.
+		};
+
+		// Members
+		std::shared_ptr<Bus> _bus;
+		mutable std::mutex   _mtx;
+		Config               _config;
+		std::mt19937_64      _rng;
+		Stats                _stats;
+
+		// Methods
+		Fault _draw(const double failProb, const double corruptProb) noexcept(true); // Call with _mtx locked.
+		bool _hit(const double prob) noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef FAULT_INJECTION_BUS_HPP"
+
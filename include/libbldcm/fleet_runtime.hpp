@@ -0,0 +1,116 @@
+#ifndef FLEET_RUNTIME_HPP
+#define FLEET_RUNTIME_HPP
+
+#include <libbldcm.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+namespace bldcm {
+// Runtime partitioning motors across worker threads pinned to cores.
+// A motor and its tasks form a unit which is owned by one worker at a time,
+// so register caches of the motor are never accessed concurrently.
+// Idle workers steal whole units whose tasks are overdue from other workers.
+class FleetRuntime {
+	public:
+		// Type define
+		using Task = std::function<void(Motor &motor)>;
+
+		struct WorkerStats {
+			int      cpu;         // Pinned CPU. Negative value means not pinned.
+			double   utilization; // Ratio of time running tasks since start.
+			uint64_t taskRunNum;
+			uint64_t stealNum;    // Number of units this worker stole.
+			std::size_t unitNum;
+		};
+
+		struct Stats {
+			std::vector<WorkerStats> workers;
+			uint64_t migratedUnitNum;
+			uint64_t migratedTaskNum;
+			uint64_t taskErrorNum; // Number of exceptions thrown from tasks.
+		};
+
+		// Constructor/Destructor
+		explicit FleetRuntime(const std::size_t workerNum, const bool isPinned = true) noexcept(false);
+		~FleetRuntime();
+
+		FleetRuntime(const FleetRuntime &) = delete;
+		FleetRuntime &operator=(const FleetRuntime &) = delete;
+
+		// Methods
+		// Return the ID of the unit. The unit is given to the worker owning the fewest units.
+		std::size_t add(std::unique_ptr<Motor> &&motor) noexcept(false);
+		void schedule(const std::size_t id, const Task &task, const std::chrono::nanoseconds &period) noexcept(false);
+		void post(const std::size_t id, const Task &task) noexcept(false); // Run once on the owner worker.
+		// Tasks run without lock of the unit, so they can schedule or post to their own unit.
+
+		void start() noexcept(false);
+		void stop() noexcept(true);
+
+		Stats stats() const noexcept(false);
+
+	private:
+		// Type define
+		using Clock = std::chrono::steady_clock;
+
+		struct ScheduledTask {
+			Task                     task;
+			std::chrono::nanoseconds period; // Zero means one-shot task.
+			Clock::time_point        next;
+		};
+
+		struct Unit {
+			std::unique_ptr<Motor>     motor;
+			std::mutex                 mtx;
+			std::vector<ScheduledTask> tasks;
+			std::vector<ScheduledTask> running; // Used only by the worker running the unit.
+			std::atomic<Clock::rep>    nextDue; // Earliest time of tasks
+		};
+
+		struct Worker {
+			int                     cpu;
+			std::thread             thread;
+			mutable std::mutex      mtx;
+			std::condition_variable cv;
+			std::deque<Unit *>      units;
+			uint64_t                wakeNum; // Incremented at every post or schedule. Guarded by mtx.
+			std::atomic<uint64_t>   busyNs;
+			std::atomic<uint64_t>   taskRunNum;
+			std::atomic<uint64_t>   stealNum;
+		};
+
+		// Materials
+		static constexpr std::chrono::microseconds _StealLag = std::chrono::microseconds(100); // Overdue to be stolen
+		static constexpr std::chrono::milliseconds _MaxIdle  = std::chrono::milliseconds(1);   // Interval to try stealing
+
+		// Members
+		std::vector<std::unique_ptr<Worker>> _workers;
+		std::vector<std::unique_ptr<Unit>>   _units;
+		mutable std::mutex                   _unitsMtx;
+		std::atomic<bool>                    _isStopRequested;
+		Clock::time_point                    _startTime;
+		std::atomic<uint64_t>                _migratedUnitNum;
+		std::atomic<uint64_t>                _migratedTaskNum;
+		std::atomic<uint64_t>                _taskErrorNum;
+
+		// Methods
+		void _run(const std::size_t idx) noexcept(true);
+		void _runUnit(Unit &unit, Worker &worker) noexcept(true);
+		bool _steal(const std::size_t idx) noexcept(true);
+		Unit &_unit(const std::size_t id) const noexcept(false);
+		void _wake() noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef FLEET_RUNTIME_HPP"
+
@@ -0,0 +1,179 @@
+#ifndef LATENCY_PROFILER_IMPL_HPP
+#define LATENCY_PROFILER_IMPL_HPP
+
+#include <libbldcm/config.hpp>
+#include <libbldcm/latency_profiler.hpp>
+#include <libbldcm.hpp>
+
+#include <vector>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <thread>
+#include <ostream>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+namespace bldcm {
+
+//========  LatencyProfiler class ========
+// Public
+LIBBLDCM_INLINE const LatencyProfiler::Config LatencyProfiler::DefaultConfig = {
+	std::chrono::nanoseconds::zero(),
+	std::chrono::seconds(1),
+	Rps(10),
+	std::chrono::microseconds(10),
+	100
+};
+
+LIBBLDCM_INLINE LatencyProfiler::LatencyProfiler() noexcept(false)
+	: LatencyProfiler(DefaultConfig)
+{
+}
+
+LIBBLDCM_INLINE LatencyProfiler::LatencyProfiler(const Config &config) noexcept(false)
+	: _config(config)
+{
+	if ((config.bandWidth <= Rps::zero()) || (config.binWidth <= std::chrono::nanoseconds::zero()) || (config.binNum == 0)) {
+		throw std::invalid_argument("Band width, bin width and bin number must be positive.");
+	}
+}
+
+LIBBLDCM_INLINE void LatencyProfiler::measure(Motor &motor, const Event event, const Rps &speed,
+                              const std::chrono::steady_clock::time_point &writeTime) noexcept(false)
+{
+	const std::chrono::steady_clock::time_point deadline = writeTime + this->_config.timeout;
+	const Key key(motor.baseAddr(), event, speed.count() / this->_config.bandWidth.count());
+	uint64_t sampleNum = 0;
+	bool isTimeout = false;
+	bool isDeasserted = false;
+	std::chrono::steady_clock::time_point now;
+
+	// Sampling is done without lock so that motors on different threads are measured in parallel.
+	while (true) {
+		const Motor::Status stat = motor.status();
+		now = std::chrono::steady_clock::now();
+		sampleNum++;
+
+		const bool isAsserted = (event == Event::reflect) ? stat.isReflectedFreq : stat.isStopping;
+
+		// The flag may be still asserted by the previous setpoint, so the transition is an edge after deassertion.
+		if (!isAsserted) {
+			isDeasserted = true;
+		} else if (isDeasserted) {
+			break;
+		}
+
+		if (now >= deadline) {
+			isTimeout = true;
+			break;
+		}
+
+		if (this->_config.samplePeriod > std::chrono::nanoseconds::zero()) {
+			std::this_thread::sleep_for(this->_config.samplePeriod);
+		}
+	}
+
+	this->_record(key, isTimeout, sampleNum, std::chrono::duration_cast<std::chrono::nanoseconds>(now - writeTime));
+}
+
+LIBBLDCM_INLINE std::vector<LatencyProfiler::Histogram> LatencyProfiler::histograms() const noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(this->_mtx);
+	std::vector<Histogram> ret;
+
+	ret.reserve(this->_histograms.size());
+	for (const auto &kv : this->_histograms) {
+		ret.push_back(kv.second);
+	}
+
+	return ret;
+}
+
+LIBBLDCM_INLINE void LatencyProfiler::writeCsv(std::ostream &os) const noexcept(false)
+{
+	const std::vector<Histogram> hists = this->histograms();
+	const std::chrono::nanoseconds::rep binWidth = this->_config.binWidth.count();
+
+	// Bin columns are labelled with their upper bound [ns]. The last one has no upper bound.
+	os << "base_addr,event,band_low_rps,band_high_rps,count,timeout_num,sample_num,min_ns,max_ns,mean_ns";
+	for (std::size_t i = 0; i < this->_config.binNum; i++) {
+		if ((i + 1) < this->_config.binNum) {
+			os << ",lt_" << (binWidth * static_cast<std::chrono::nanoseconds::rep>(i + 1));
+		} else {
+			os << ",ge_" << (binWidth * static_cast<std::chrono::nanoseconds::rep>(i));
+		}
+	}
+	os << "\n";
+
+	for (const Histogram &h : hists) {
+		const std::chrono::nanoseconds::rep mean = (h.count > 0) ? (h.total.count() / static_cast<std::chrono::nanoseconds::rep>(h.count)) : 0;
+		const std::chrono::nanoseconds::rep min  = (h.count > 0) ? h.min.count() : 0;
+
+		os << "0x" << std::hex << h.baseAddr << std::dec << ","
+		   << ((h.event == Event::reflect) ? "reflect" : "stop") << ","
+		   << h.bandLow.count() << ","
+		   << (h.bandLow + this->_config.bandWidth).count() << ","
+		   << h.count << ","
+		   << h.timeoutNum << ","
+		   << h.sampleNum << ","
+		   << min << ","
+		   << h.max.count() << ","
+		   << mean;
+		for (const uint64_t bin : h.bins) {
+			os << "," << bin;
+		}
+		os << "\n";
+	}
+}
+
+LIBBLDCM_INLINE void LatencyProfiler::reset() noexcept(true)
+{
+	std::lock_guard<std::mutex> lock(this->_mtx);
+	this->_histograms.clear();
+}
+
+LIBBLDCM_INLINE const LatencyProfiler::Config &LatencyProfiler::config() const noexcept(true)
+{
+	return this->_config;
+}
+
+// Private
+LIBBLDCM_INLINE void LatencyProfiler::_record(const Key &key, const bool isTimeout, const uint64_t sampleNum,
+                              const std::chrono::nanoseconds &latency) noexcept(false)
+{
+	std::lock_guard<std::mutex> lock(this->_mtx);
+	auto itr = this->_histograms.find(key);
+
+	if (itr == this->_histograms.end()) {
+		const Histogram init = {
+			std::get<0>(key), std::get<1>(key), this->_config.bandWidth * std::get<2>(key),
+			0, 0, 0, std::chrono::nanoseconds::max(), std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero(),
+			std::vector<uint64_t>(this->_config.binNum, 0)
+		};
+		itr = this->_histograms.emplace(key, init).first;
+	}
+
+	Histogram &h = itr->second;
+
+	h.sampleNum += sampleNum;
+
+	// Timed-out measurements are counted separately so that they don't distort the distribution.
+	if (isTimeout) {
+		h.timeoutNum++;
+		return;
+	}
+
+	const std::size_t bin = static_cast<std::size_t>(latency.count() / this->_config.binWidth.count());
+
+	h.count++;
+	h.min   = std::min(h.min, latency);
+	h.max   = std::max(h.max, latency);
+	h.total += latency;
+	h.bins[std::min(bin, this->_config.binNum - 1)]++;
+}
+
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef LATENCY_PROFILER_IMPL_HPP"
@@ -0,0 +1,554 @@
+#ifndef MOTOR_IMPL_HPP
+#define MOTOR_IMPL_HPP
+
+#include <libbldcm/config.hpp>
+#include <libbldcm.hpp>
+#include <libbldcm/register_map.hpp>
+#include <libbldcm/shadow_store.hpp>
+#include <libbldcm/latency_profiler.hpp>
+
+#include <memory>
+#include <limits>
+#include <utility>
+#include <stdexcept>
+#include <chrono>
+#include <ratio>
+#include <cmath>
+#include <algorithm>
+
+namespace bldcm {
+
+//========  Motor class ========
+// Public
+template<typename ClkFqType>
+Motor::Motor(const std::shared_ptr<Fpgasoc> &ptr, const ClkFqType &clkFq, const uint32_t baseAddr,
+             const std::shared_ptr<ShadowStore> &shadowStore)
+	: Motor(std::shared_ptr<Bus>(std::make_shared<FpgasocBus>(ptr)), clkFq, baseAddr, shadowStore)
+{
+}
+
+template<typename ClkFqType>
+Motor::Motor(const std::shared_ptr<Bus> &ptr, const ClkFqType &clkFq, const uint32_t baseAddr,
+             const std::shared_ptr<ShadowStore> &shadowStore)
+	: _regmap(ptr, baseAddr), _clkFq(clockFreq_cast<Hz>(clkFq)), _shadowStore(shadowStore)
+{
+	if (this->_shadowStore) {
+		this->_shadowSlot = &this->_shadowStore->slot(baseAddr);
+
+		if (this->_resumeFromShadow()) {
+			this->_isResumed = true;
+			return;
+		}
+
+		this->_shadowSlot->isValid = 0U;
+		this->_shadowSlot->clkFq   = this->_clkFq.count();
+		this->_regmap.attachShadow(this->_shadowSlot->regs, false);
+	}
+
+	// Try to fetch HW IP version and deadtime.
+	this->_regmap.stat.updateCache();
+	this->_fetchHwIpVersion(true);
+	this->_fetchDeadtime(true);
+
+	// Try to fetch PWM duty
+	this->_calcPwmDutyFromRegister();
+
+	if (this->_shadowSlot != nullptr) {
+		this->_storeToShadow();
+		this->_shadowSlot->isValid = 1U;
+	}
+}
+
+template<typename RotationalSpeedType> // RotationalSpeedType is Rps or Rpm.
+void Motor::rotationalSpeed(const RotationalSpeedType &speed) noexcept(false)
+{
+	const uint32_t rps = static_cast<uint32_t>(rotationalSpeed_cast<Rps>(speed).count());
+
+	if (!this->_profiler) {
+		this->_regmap.freqtgt.freqtgt(rps);
+	} else {
+		// New setpoint is reflected only while rotating. The same setpoint causes no transition.
+		const bool isEnabled = (this->_regmap.ctrl.en(true) == CtrlReg::En::Val::Enable);
+		const bool isChanged = (this->_regmap.freqtgt.cacheStatus() != FreqtgtReg::CacheState::sync) ||
+		                       (this->_regmap.freqtgt.freqtgt(true) != rps);
+		const std::chrono::steady_clock::time_point writeTime = std::chrono::steady_clock::now();
+
+		this->_regmap.freqtgt.freqtgt(rps);
+		if (isEnabled && isChanged && (rps != static_cast<uint32_t>(0U))) {
+			this->_profiler->measure(*this, LatencyProfiler::Event::reflect, Rps(rps), writeTime);
+		}
+	}
+}
+
+template<typename RotationalSpeedType>
+RotationalSpeedType Motor::rotationalSpeed() noexcept(false)
+{
+	const uint32_t rpstmp = this->_regmap.freqtgt.freqtgt();
+	const Rps rps(rpstmp);
+
+	return rotationalSpeed_cast<RotationalSpeedType>(rps);
+}
+
+LIBBLDCM_INLINE void Motor::pwmDuty(const int duty) noexcept(false)
+{
+	const CtrlReg::CacheState cacheStatus = this->_regmap.ctrl.cacheStatus();
+	uint16_t pwmMaxcnt;
+	uint32_t pwmCmp;
+
+	if (cacheStatus == CtrlReg::CacheState::initialized) {
+		pwmMaxcnt = this->_regmap.ctrl.pwmMaxcnt();
+	} else if (cacheStatus == CtrlReg::CacheState::sync) {
+		pwmMaxcnt = this->_regmap.ctrl.pwmMaxcnt(true);
+	} else {
+		throw std::runtime_error("Try to fetch pwmMaxcnt but the reg cache is modified.");
+	}
+
+	if (duty == static_cast<int>(100)) {
+		pwmCmp = pwmMaxcnt + static_cast<int>(1); 
+	} else if ((duty >= static_cast<int>(0)) && (duty < static_cast<int>(100))) {
+		pwmCmp = (pwmMaxcnt * static_cast<uint32_t>(duty)) / static_cast<uint32_t>(100U);
+	} else {
+		throw std::out_of_range("PwmDuty is out of range.");
+	}
+
+	this->_regmap.pwmCmp.pwmCmp(pwmCmp);
+
+	this->_pwmDuty = std::make_pair(true, duty);
+	this->_storeToShadow();
+}
+
+LIBBLDCM_INLINE int  Motor::pwmDuty() noexcept(false)
+{
+	// This const value can be updated, because it's reference value.
+	const bool &isPwmDutyValid = this->_pwmDuty.first;
+
+	if (!isPwmDutyValid) {
+		this->_calcPwmDutyFromRegister();
+	}
+
+	if (!isPwmDutyValid) {
+		throw std::runtime_error("PWM duty cannot be fetched from register.");
+	}
+
+	return this->_pwmDuty.second;
+}
+
+LIBBLDCM_INLINE void Motor::outputEnable(bool isEnable) noexcept(false)
+{
+	if (this->_regmap.ctrl.cacheStatus() != CtrlReg::CacheState::modified) {
+		const uint8_t writeVal = (isEnable) ? CtrlReg::En::Val::Enable : CtrlReg::En::Val::Disable;
+
+		if (!this->_profiler) {
+			this->_regmap.ctrl.en(writeVal);
+		} else {
+			// Stopping is measured only if the motor was rotating.
+			const uint32_t rps = this->_regmap.freqtgt.freqtgt(true);
+			const bool isRotating = (this->_regmap.ctrl.en(true) == CtrlReg::En::Val::Enable) && (rps != static_cast<uint32_t>(0U));
+			const std::chrono::steady_clock::time_point writeTime = std::chrono::steady_clock::now();
+
+			this->_regmap.ctrl.en(writeVal);
+			if ((!isEnable) && isRotating) {
+				this->_profiler->measure(*this, LatencyProfiler::Event::stop, Rps(rps), writeTime);
+			}
+		}
+	} else {
+		throw std::runtime_error("Cache of CtrlReg is modified at writing CTRL.EN.");
+	}
+}
+
+LIBBLDCM_INLINE bool Motor::outputEnable() noexcept(false)
+{
+	bool ret = false;
+
+	if (this->_regmap.ctrl.cacheStatus() != CtrlReg::CacheState::modified) {
+		const uint8_t readVal = this->_regmap.ctrl.en();
+
+		if (readVal == CtrlReg::En::Val::Enable) {
+			ret = true;
+		} else if (readVal == CtrlReg::En::Val::Disable) {
+			// Do nothing.
+		} else {
+			throw std::runtime_error("The value read from CTRL.EN is garbled.");
+		}
+	}
+
+	return ret;
+}
+
+LIBBLDCM_INLINE bool Motor::outputEnable(const std::chrono::nanoseconds &maxAge) noexcept(false)
+{
+	bool ret = false;
+
+	if (this->_regmap.ctrl.cacheStatus() != CtrlReg::CacheState::modified) {
+		this->_regmap.ctrl.reg(maxAge);
+		const uint8_t readVal = this->_regmap.ctrl.en(true);
+
+		if (readVal == CtrlReg::En::Val::Enable) {
+			ret = true;
+		} else if (readVal == CtrlReg::En::Val::Disable) {
+			// Do nothing.
+		} else {
+			throw std::runtime_error("The value read from CTRL.EN is garbled.");
+		}
+	}
+
+	return ret;
+}
+
+template<typename PeriodType>
+void Motor::pwmPeriod(const PeriodType &period, const int prsc) noexcept(false)
+{
+	const std::chrono::nanoseconds periodNs = std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+	// periodMaxCountNs = (((_MaxPwmcnt * 2) * 2^prsc) / clockFreq) 10^9;
+	const std::chrono::nanoseconds::rep periodMaxCountNs = ((_MaxPwmMaxcnt * std::nano::den) << (prsc + static_cast<int>(1))) / (std::nano::num * this->_clkFq.count());
+	const std::chrono::nanoseconds periodMax(periodMaxCountNs);
+	uint16_t pwmMaxcnt;
+
+	if ((prsc > _MaxPrscSel) || (prsc < _MinPrscSel)) {
+		throw std::out_of_range("Prescaler selection # is out of range.");
+	}
+
+	if (periodNs > periodMax) {
+		throw std::out_of_range("Combination of period and prescaler is out of range.");
+	}
+
+	//pwmMaxcnt = ((period[ns] * clockFreq[Hz]) / (2^prsc * 2)) * 10^(-9);
+	pwmMaxcnt = static_cast<uint16_t>(((periodNs.count() * this->_clkFq.count() * std::nano::num) / std::nano::den) >> (prsc + static_cast<int>(1)));
+
+	if (this->_regmap.ctrl.cacheStatus() != CtrlReg::CacheState::modified) {
+		this->_regmap.ctrl.pwmMaxcnt(pwmMaxcnt, true);
+		this->_regmap.ctrl.pwmPrsc(static_cast<uint8_t>(prsc), true);
+		this->_regmap.ctrl.flushCache();
+		// Update PWM_CMP based on duty.
+		this->pwmDuty(this->pwmDuty());
+	} else {
+		throw std::runtime_error("Cache of CtrlReg is modified at trying flushing PWM Period.");
+	}
+}
+
+template<typename PeriodType>
+std::pair<PeriodType, int> Motor::pwmPeriod() noexcept(false)
+{
+	if (this->_regmap.ctrl.cacheStatus() != CtrlReg::CacheState::modified) {
+		this->_regmap.ctrl.updateCache();
+	} else {
+		throw std::runtime_error("Cache of CtrlReg is modified at trying fetching PWM Period.");
+	}
+
+	return this->_pwmPeriodFromCache<PeriodType>();
+}
+
+template<typename PeriodType>
+std::pair<PeriodType, int> Motor::pwmPeriod(const std::chrono::nanoseconds &maxAge) noexcept(false)
+{
+	if (this->_regmap.ctrl.cacheStatus() != CtrlReg::CacheState::modified) {
+		this->_regmap.ctrl.reg(maxAge);
+	} else {
+		throw std::runtime_error("Cache of CtrlReg is modified at trying fetching PWM Period.");
+	}
+
+	return this->_pwmPeriodFromCache<PeriodType>();
+}
+
+LIBBLDCM_INLINE void Motor::phase(const int phase) noexcept(false)
+{
+	if ((phase < _MinPhase) || (phase > _MaxPhase)) {
+		throw std::out_of_range("Phase is out of range.");
+	}
+
+	this->_regmap.ctrl.phase(static_cast<uint8_t>(phase));
+}
+
+LIBBLDCM_INLINE int Motor::phase() noexcept(false)
+{
+	return static_cast<int>(this->_regmap.ctrl.phase());
+}
+
+LIBBLDCM_INLINE const std::string &Motor::hwIpVersion() noexcept(false)
+{
+	// Check whether HW IP version is valid.
+	if (!this->_hwIpVersion.first) {
+		if (this->_regmap.stat.cacheStatus() == StatReg::CacheState::sync) {
+			this->_fetchHwIpVersion(true);
+		} else if (this->_regmap.stat.cacheStatus() == StatReg::CacheState::initialized) {
+			this->_fetchHwIpVersion(false);
+		} else {
+			throw std::runtime_error("Cache is modified at trying fetching HW IP version.");
+		}
+	}
+
+	if (!this->_hwIpVersion.first) {
+		throw std::runtime_error("Fail to fetch HW IP version.");
+	}
+
+	return this->_hwIpVersion.second;
+}
+
+LIBBLDCM_INLINE const int &Motor::deadtime()
+{
+	// Check whether HW IP version is valid.
+	if (!this->_deadtime.first) {
+		if (this->_regmap.stat.cacheStatus() == StatReg::CacheState::sync) {
+			this->_fetchDeadtime(true);
+		} else if (this->_regmap.stat.cacheStatus() == StatReg::CacheState::initialized) {
+			this->_fetchDeadtime(false);
+		} else {
+			throw std::runtime_error("Cache is modified at trying fetching deadtime.");
+		}
+	}
+
+	if (!this->_deadtime.first) {
+		throw std::runtime_error("Fail to fetch deadtime.");
+	}
+
+	return this->_deadtime.second;
+}
+
+LIBBLDCM_INLINE bool Motor::isReflectedFreq() noexcept(false)
+{
+	bool ret = false;
+
+	if (this->_regmap.stat.cacheStatus() != StatReg::CacheState::modified) {
+		if (this->_regmap.stat.reflectedfreq() == StatReg::Reflectedfreq::Val::Reflected) {
+			ret = true;
+		}
+	} else {
+		throw std::runtime_error("Cache is modified at trying fetching STAT.REFLECTEDFREQ flug.");
+	}
+
+	return ret;
+}
+
+LIBBLDCM_INLINE bool Motor::isStopping() noexcept(false)
+{
+	bool ret = false;
+
+	if (this->_regmap.stat.cacheStatus() != StatReg::CacheState::modified) {
+		if (this->_regmap.stat.stop() == StatReg::Stop::Val::Stopping) {
+			ret = true;
+		}
+	} else {
+		throw std::runtime_error("Cache is modified at trying fetching STAT.STOP flug.");
+	}
+
+	return ret;
+}
+
+LIBBLDCM_INLINE Motor::Status Motor::status() noexcept(false)
+{
+	Status ret;
+
+	if (this->_regmap.stat.cacheStatus() != StatReg::CacheState::modified) {
+		this->_regmap.stat.updateCache();
+		ret.isStopping      = (this->_regmap.stat.stop(true) == StatReg::Stop::Val::Stopping);
+		ret.isReflectedFreq = (this->_regmap.stat.reflectedfreq(true) == StatReg::Reflectedfreq::Val::Reflected);
+	} else {
+		throw std::runtime_error("Cache is modified at trying fetching STAT.");
+	}
+
+	return ret;
+}
+
+LIBBLDCM_INLINE bool Motor::isReflectedFreq(const std::chrono::nanoseconds &maxAge) noexcept(false)
+{
+	return this->status(maxAge).isReflectedFreq;
+}
+
+LIBBLDCM_INLINE bool Motor::isStopping(const std::chrono::nanoseconds &maxAge) noexcept(false)
+{
+	return this->status(maxAge).isStopping;
+}
+
+LIBBLDCM_INLINE Motor::Status Motor::status(const std::chrono::nanoseconds &maxAge) noexcept(false)
+{
+	Status ret;
+
+	if (this->_regmap.stat.cacheStatus() != StatReg::CacheState::modified) {
+		this->_regmap.stat.reg(maxAge);
+		ret.isStopping      = (this->_regmap.stat.stop(true) == StatReg::Stop::Val::Stopping);
+		ret.isReflectedFreq = (this->_regmap.stat.reflectedfreq(true) == StatReg::Reflectedfreq::Val::Reflected);
+	} else {
+		throw std::runtime_error("Cache is modified at trying fetching STAT.");
+	}
+
+	return ret;
+}
+
+LIBBLDCM_INLINE const Register &Motor::ctrlReg() const noexcept(true)
+{
+	return this->_regmap.ctrl;
+}
+
+LIBBLDCM_INLINE const Register &Motor::statReg() const noexcept(true)
+{
+	return this->_regmap.stat;
+}
+
+LIBBLDCM_INLINE void Motor::profiler(const std::shared_ptr<LatencyProfiler> &profiler) noexcept(true)
+{
+	this->_profiler = profiler;
+}
+
+LIBBLDCM_INLINE uint32_t Motor::baseAddr() const noexcept(true)
+{
+	// FREQTGT is placed at the base address.
+	return this->_regmap.freqtgt.address();
+}
+
+LIBBLDCM_INLINE void Motor::retryPolicy(const Register::RetryPolicy &policy) noexcept(true)
+{
+	this->_regmap.retryPolicy(policy);
+}
+
+LIBBLDCM_INLINE RegMap &Motor::regMap() noexcept(true)
+{
+	return this->_regmap;
+}
+
+LIBBLDCM_INLINE void Motor::pwmDutyCache(const int duty) noexcept(true)
+{
+	this->_pwmDuty = std::make_pair(true, duty);
+	this->_storeToShadow();
+}
+
+LIBBLDCM_INLINE bool Motor::isResumed() const noexcept(true)
+{
+	return this->_isResumed;
+}
+
+// Private
+LIBBLDCM_INLINE void Motor::_fetchHwIpVersion(const bool fromCache) noexcept(true)
+{
+	bool isFetchFail = false;
+	uint8_t relCnt = std::numeric_limits<uint8_t>::max();
+
+	try {
+		relCnt = this->_regmap.stat.relCnt(fromCache);
+
+	} catch (const std::range_error &e) {
+		isFetchFail = true;
+	}
+
+	if (!isFetchFail) {
+		if (relCnt <= StatReg::RelCnt::MaxVal) {
+			this->_hwIpVersion = std::make_pair(true, StatReg::RelCnt::VerTbl[relCnt]);
+			this->_storeToShadow();
+		} 
+	}
+}
+
+LIBBLDCM_INLINE void Motor::_fetchDeadtime(const bool fromCache) noexcept(true)
+{
+	bool    isFetchFail = false;
+	uint8_t deadtime = std::numeric_limits<uint8_t>::max();
+
+	try {
+		deadtime = this->_regmap.stat.deadtime(fromCache);
+
+	} catch (const std::range_error &e) {
+		isFetchFail = true;
+	}
+
+	if (!isFetchFail) {
+		this->_deadtime = std::make_pair(true, static_cast<int>(deadtime));
+		this->_storeToShadow();
+	}
+}
+
+LIBBLDCM_INLINE void Motor::_calcPwmDutyFromRegister() noexcept(true)
+{
+	const CtrlReg::CacheState   cacheStatusCtrl   = this->_regmap.ctrl.cacheStatus();
+	const PwmCmpReg::CacheState cacheStatusPwmCmp = this->_regmap.pwmCmp.cacheStatus();
+	uint16_t pwmMaxcnt;
+	uint32_t pwmCmp;
+	bool     isFetchFail = false;
+
+	try {
+		if ((cacheStatusCtrl   != CtrlReg::CacheState::modified) &&
+		    (cacheStatusPwmCmp != PwmCmpReg::CacheState::modified)) {
+			pwmCmp = this->_regmap.pwmCmp.pwmCmp();
+			pwmMaxcnt = this->_regmap.ctrl.pwmMaxcnt();
+		} else {
+			throw std::runtime_error("Try to fetch pwmMaxcnt or pwmCmp but the reg cache is modified.");
+		}
+	} catch(...) {
+		isFetchFail = true;
+	}
+
+	if (!isFetchFail) {
+		if (pwmCmp > static_cast<uint32_t>(pwmMaxcnt)) {
+			this->_pwmDuty = std::make_pair(true, static_cast<int>(100));
+		} else if (pwmMaxcnt > static_cast<uint16_t>(0U)) {
+			double dutyl = (static_cast<double>(pwmCmp) * static_cast<double>(100.)) / static_cast<double>(pwmMaxcnt);
+			int duty = static_cast<int>(std::round(dutyl));
+			this->_pwmDuty = std::make_pair(true, duty);
+		} else {
+			this->_pwmDuty = std::make_pair(false, _InvalidPwmDuty);
+		}
+
+		this->_storeToShadow();
+	}
+}
+
+template<typename PeriodType>
+std::pair<PeriodType, int> Motor::_pwmPeriodFromCache() noexcept(false)
+{
+	const uint8_t  pwmPrsc   = this->_regmap.ctrl.pwmPrsc(true);
+	const uint16_t pwmMaxcnt = this->_regmap.ctrl.pwmMaxcnt(true);
+	std::chrono::nanoseconds::rep countNs;
+
+	//countNs = (((pwmMaxcnt * 2) * 2^prsc) / clockFreq) * 10^9;
+	countNs = ((pwmMaxcnt * std::nano::den) << (pwmPrsc + static_cast<uint8_t>(1))) / (std::nano::num * this->_clkFq.count());
+
+	return std::make_pair(std::chrono::duration_cast<PeriodType>(std::chrono::nanoseconds(countNs)), static_cast<int>(pwmPrsc));
+}
+
+LIBBLDCM_INLINE bool Motor::_resumeFromShadow() noexcept(true)
+{
+	const ShadowStore::Slot &slot = *this->_shadowSlot;
+	bool isResumable = false;
+
+	if ((slot.isValid != 0U) && (slot.clkFq == this->_clkFq.count()) &&
+	    (slot.regs.ctrl.cacheStatus == CtrlReg::CacheState::sync)) {
+		// Single verification read. CTRL is read anyway at cold initialization.
+		try {
+			isResumable = (this->_regmap.ctrl.reg() == slot.regs.ctrl.regCache);
+		} catch (const std::range_error &e) {
+			isResumable = false;
+		}
+	}
+
+	if (isResumable) {
+		this->_regmap.attachShadow(this->_shadowSlot->regs, true);
+
+		if ((slot.relCnt >= 0) && (slot.relCnt <= StatReg::RelCnt::MaxVal)) {
+			this->_hwIpVersion = std::make_pair(true, StatReg::RelCnt::VerTbl[slot.relCnt]);
+		}
+		if (slot.deadtime >= 0) {
+			this->_deadtime = std::make_pair(true, static_cast<int>(slot.deadtime));
+		}
+		if (slot.pwmDuty >= 0) {
+			this->_pwmDuty = std::make_pair(true, static_cast<int>(slot.pwmDuty));
+		}
+	}
+
+	return isResumable;
+}
+
+LIBBLDCM_INLINE void Motor::_storeToShadow() noexcept(true)
+{
+	if (this->_shadowSlot == nullptr) {
+		return;
+	}
+
+	const auto &verTbl = StatReg::RelCnt::VerTbl;
+	const auto  verItr = std::find(verTbl.begin(), verTbl.end(), this->_hwIpVersion.second);
+
+	this->_shadowSlot->relCnt   = (this->_hwIpVersion.first && (verItr != verTbl.end())) ? static_cast<int32_t>(verItr - verTbl.begin()) : static_cast<int32_t>(-1);
+	this->_shadowSlot->deadtime = (this->_deadtime.first) ? static_cast<int32_t>(this->_deadtime.second) : static_cast<int32_t>(-1);
+	this->_shadowSlot->pwmDuty  = (this->_pwmDuty.first) ? static_cast<int32_t>(this->_pwmDuty.second) : static_cast<int32_t>(-1);
+}
+
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef MOTOR_IMPL_HPP"
@@ -0,0 +1,388 @@
+#ifndef REGISTER_MAP_IMPL_HPP
+#define REGISTER_MAP_IMPL_HPP
+
+#include <libbldcm/config.hpp>
+#include <libbldcm/register_map.hpp>
+
+#include <libfpgasoc.hpp>
+#include <memory>
+#include <stdexcept>
+#include <array>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+namespace bldcm {
+namespace detail {
+// Utilities
+inline uint32_t pickupValue(const uint32_t value, const uint32_t bitPos, const uint32_t bitMask)
+{
+	return ((value & bitMask) >> bitPos);
+}
+
+inline void insertValue(uint32_t &updatedValue, const uint32_t insertedValue, const uint32_t bitPos, const uint32_t bitMask)
+{
+	updatedValue = (updatedValue & (~bitMask)) | ((insertedValue << bitPos) & bitMask);
+}
+} // End of "namespace detail"
+
+// Register
+LIBBLDCM_INLINE const Register::RetryPolicy Register::NoRetry = {
+	0,
+	std::chrono::nanoseconds::zero(),
+	std::chrono::nanoseconds::zero(),
+	std::chrono::nanoseconds::max()
+};
+
+LIBBLDCM_INLINE void Register::reg(const Register &reg, const bool isOnlyWriteCache) noexcept(false)
+{
+	const uint32_t origCache = this->_shadow->regCache;
+
+	this->_shadow->regCache = reg._shadow->regCache;
+
+	if (isOnlyWriteCache) {
+		this->_shadow->cacheStatus = CacheState::modified;
+	} else {
+		try {
+			this->flushCache();
+		} catch (const std::range_error &e) {
+			this->_shadow->regCache = origCache;
+			throw;
+		}
+	}
+}
+
+LIBBLDCM_INLINE void Register::reg(const uint32_t &val, const bool isOnlyWriteCache) noexcept(false)
+{
+	const uint32_t origCache = this->_shadow->regCache;
+
+	this->_shadow->regCache = val;
+
+	if (isOnlyWriteCache) {
+		this->_shadow->cacheStatus = CacheState::modified;
+	} else {
+		try {
+			this->flushCache();
+		} catch (const std::range_error &e) {
+			this->_shadow->regCache = origCache;
+			throw;
+		}
+	}
+}
+
+LIBBLDCM_INLINE uint32_t Register::reg(const bool isReadFromCache) noexcept(false)
+{
+	if (!isReadFromCache) {
+		this->updateCache();
+	}
+
+	return this->_shadow->regCache;
+}
+
+LIBBLDCM_INLINE uint32_t Register::reg(const std::chrono::nanoseconds &maxAge) noexcept(false)
+{
+	const bool isFilled = (this->_shadow->cacheStatus == CacheState::sync) && (this->_fillTime != std::chrono::steady_clock::time_point::min());
+
+	if (isFilled && ((std::chrono::steady_clock::now() - this->_fillTime) <= maxAge)) {
+		this->_cacheHitNum++;
+	} else {
+		this->_cacheMissNum++;
+		this->updateCache();
+	}
+
+	return this->_shadow->regCache;
+}
+
+LIBBLDCM_INLINE void Register::flushCache() noexcept(false)
+{
+	this->_retry([this]() { this->_bus.write32(this->_addr, this->_shadow->regCache); });
+	this->_shadow->cacheStatus = CacheState::sync;
+	this->_fillTime = std::chrono::steady_clock::now();
+	this->_flushCacheCallBack();
+}
+
+LIBBLDCM_INLINE void Register::updateCache() noexcept(false)
+{
+	uint32_t val = static_cast<uint32_t>(0U);
+
+	this->_retry([this, &val]() { val = this->_bus.read32(this->_addr); });
+	this->_shadow->regCache = val;
+	this->_shadow->cacheStatus = CacheState::sync;
+	this->_fillTime = std::chrono::steady_clock::now();
+}
+
+LIBBLDCM_INLINE uint32_t Register::address() const noexcept(true)
+{
+	return this->_addr;
+}
+
+LIBBLDCM_INLINE Register::CacheState Register::cacheStatus() const noexcept(true)
+{
+	return this->_shadow->cacheStatus;
+}
+
+LIBBLDCM_INLINE std::chrono::steady_clock::time_point Register::fillTime() const noexcept(true)
+{
+	return this->_fillTime;
+}
+
+LIBBLDCM_INLINE uint64_t Register::cacheHitNum() const noexcept(true)
+{
+	return this->_cacheHitNum;
+}
+
+LIBBLDCM_INLINE uint64_t Register::cacheMissNum() const noexcept(true)
+{
+	return this->_cacheMissNum;
+}
+
+LIBBLDCM_INLINE double Register::cacheHitRatio() const noexcept(true)
+{
+	const uint64_t total = this->_cacheHitNum + this->_cacheMissNum;
+	return (total > 0) ? (static_cast<double>(this->_cacheHitNum) / static_cast<double>(total)) : 0.;
+}
+
+LIBBLDCM_INLINE void Register::attachShadow(Register::Shadow &shadow, const bool isRestore) noexcept(true)
+{
+	if (!isRestore) {
+		shadow = *this->_shadow;
+	} else {
+		// Age of restored cache is unknown.
+		this->_fillTime = std::chrono::steady_clock::time_point::min();
+	}
+
+	this->_shadow = &shadow;
+}
+
+LIBBLDCM_INLINE void Register::detachShadow() noexcept(true)
+{
+	if (this->_shadow != &this->_localShadow) {
+		this->_localShadow = *this->_shadow;
+		this->_shadow = &this->_localShadow;
+	}
+}
+
+LIBBLDCM_INLINE void Register::retryPolicy(const Register::RetryPolicy &policy) noexcept(true)
+{
+	this->_retryPolicy = policy;
+}
+
+LIBBLDCM_INLINE const Register::RetryPolicy &Register::retryPolicy() const noexcept(true)
+{
+	return this->_retryPolicy;
+}
+
+LIBBLDCM_INLINE uint64_t Register::retryNum() const noexcept(true)
+{
+	return this->_retryNum;
+}
+
+LIBBLDCM_INLINE void Register::_forceSetCacheStatus(const Register::CacheState newState) noexcept(true)
+{
+	this->_shadow->cacheStatus = newState;
+}
+
+template<typename Access>
+void Register::_retry(const Access &access) noexcept(false)
+{
+	const RetryPolicy &policy = this->_retryPolicy;
+
+	// Keep the hot path free of clock reads when retry is disabled.
+	if (policy.maxRetryNum == 0) {
+		access();
+		return;
+	}
+
+	// Deadline is the budget of the whole operation including the first try.
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point tryStart = start;
+	std::chrono::nanoseconds backoff = policy.initialBackoff;
+
+	for (uint32_t retryCnt = 0; ; retryCnt++) {
+		try {
+			access();
+			return;
+		} catch (const std::range_error &e) {
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			const std::chrono::nanoseconds elapsed = now - start;
+			// The next try is expected to take as long as the last one.
+			const std::chrono::nanoseconds tryTime = now - tryStart;
+
+			// Fail fast instead of running beyond the deadline.
+			if ((retryCnt >= policy.maxRetryNum) || ((backoff + tryTime) > (policy.deadline - elapsed))) {
+				throw;
+			}
+		}
+
+		this->_retryNum++;
+		if (backoff > std::chrono::nanoseconds::zero()) {
+			std::this_thread::sleep_for(backoff);
+		}
+		backoff = std::min(backoff * 2, policy.maxBackoff);
+		tryStart = std::chrono::steady_clock::now();
+	}
+}
+
+// FreqtgtReg
+LIBBLDCM_INLINE void FreqtgtReg::freqtgt(const uint32_t val, const bool isOnlyWriteCache) noexcept(false)
+{
+	this->reg(val, isOnlyWriteCache);
+}
+
+LIBBLDCM_INLINE uint32_t FreqtgtReg::freqtgt(const bool isReadFromCache) noexcept(false)
+{
+	return this->reg(isReadFromCache);
+}
+
+// PwmCmpReg
+LIBBLDCM_INLINE void PwmCmpReg::pwmCmp(const uint32_t val, const bool isOnlyWriteCache) noexcept(false)
+{
+	uint32_t regValue = this->reg(isOnlyWriteCache);
+
+	detail::insertValue(regValue, val, PwmCmp::Bit::Pos, PwmCmp::Bit::Mask);
+
+	this->reg(regValue, isOnlyWriteCache);
+}
+
+LIBBLDCM_INLINE uint32_t PwmCmpReg::pwmCmp(const bool isReadFromCache) noexcept(false)
+{
+	return detail::pickupValue(this->reg(isReadFromCache), PwmCmp::Bit::Pos, PwmCmp::Bit::Mask);
+}
+
+// CtrlReg
+LIBBLDCM_INLINE void CtrlReg::pwmMaxcnt(const uint16_t val, const bool isOnlyWriteCache) noexcept(false)
+{
+	uint32_t regValue = this->reg(isOnlyWriteCache);
+
+	detail::insertValue(regValue, static_cast<uint32_t>(val), PwmMaxcnt::Bit::Pos, PwmMaxcnt::Bit::Mask);
+
+	this->reg(regValue, isOnlyWriteCache);
+}
+
+LIBBLDCM_INLINE uint16_t CtrlReg::pwmMaxcnt(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), PwmMaxcnt::Bit::Pos, PwmMaxcnt::Bit::Mask);
+	return static_cast<uint16_t>(ret);
+}
+
+LIBBLDCM_INLINE void CtrlReg::pwmPrsc(const uint8_t val, const bool isOnlyWriteCache) noexcept(false)
+{
+	uint32_t regValue = this->reg(isOnlyWriteCache);
+
+	detail::insertValue(regValue, static_cast<uint32_t>(val), PwmPrsc::Bit::Pos, PwmPrsc::Bit::Mask);
+
+	this->reg(regValue, isOnlyWriteCache);
+}
+
+LIBBLDCM_INLINE uint8_t CtrlReg::pwmPrsc(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), PwmPrsc::Bit::Pos, PwmPrsc::Bit::Mask);
+	return static_cast<uint8_t>(ret);
+}
+
+LIBBLDCM_INLINE void CtrlReg::phase(const uint8_t val, const bool isOnlyWriteCache) noexcept(false)
+{
+	uint32_t regValue = this->reg(isOnlyWriteCache);
+
+	// Insert PHASE
+	detail::insertValue(regValue, static_cast<uint32_t>(val), Phase::Bit::Pos, Phase::Bit::Mask);
+	// Insert W_PHASE
+	detail::insertValue(regValue, static_cast<uint32_t>(WPhase::Val::Write), WPhase::Bit::Pos, WPhase::Bit::Mask);
+
+	this->reg(regValue, isOnlyWriteCache);
+}
+
+LIBBLDCM_INLINE uint8_t CtrlReg::phase(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), Phase::Bit::Pos, Phase::Bit::Mask);
+	return static_cast<uint8_t>(ret);
+}
+
+LIBBLDCM_INLINE void CtrlReg::_flushCacheCallBack() noexcept(true)
+{
+	// After writing back to register, W_PHASE bit of cache must be clear.
+	uint32_t regValue = this->reg(true);
+	detail::insertValue(regValue, static_cast<uint32_t>(WPhase::Val::NotWrite), WPhase::Bit::Pos, WPhase::Bit::Mask);
+	this->reg(regValue, true);
+	this->_forceSetCacheStatus(CacheState::sync);
+}
+
+LIBBLDCM_INLINE void CtrlReg::en(const uint8_t val, const bool isOnlyWriteCache) noexcept(false)
+{
+	uint32_t regValue = this->reg(isOnlyWriteCache);
+
+	detail::insertValue(regValue, static_cast<uint32_t>(val), En::Bit::Pos, En::Bit::Mask);
+
+	this->reg(regValue, isOnlyWriteCache);
+}
+
+LIBBLDCM_INLINE uint8_t CtrlReg::en(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), En::Bit::Pos, En::Bit::Mask);
+	return static_cast<uint8_t>(ret);
+}
+
+// StatReg
+LIBBLDCM_INLINE const std::array<std::string, StatReg::RelCnt::MaxVal+1> StatReg::RelCnt::VerTbl = {
+	"UNDR 2.10",
+	"2.10"
+};
+
+LIBBLDCM_INLINE uint8_t StatReg::relCnt(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), RelCnt::Bit::Pos, RelCnt::Bit::Mask);
+	return static_cast<uint8_t>(ret);
+}
+
+LIBBLDCM_INLINE uint8_t StatReg::deadtime(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), Deadtime::Bit::Pos, Deadtime::Bit::Mask);
+	return static_cast<uint8_t>(ret);
+}
+
+LIBBLDCM_INLINE uint8_t StatReg::reflectedfreq(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), Reflectedfreq::Bit::Pos, Reflectedfreq::Bit::Mask);
+	return static_cast<uint8_t>(ret);
+}
+
+LIBBLDCM_INLINE uint8_t StatReg::stop(const bool isReadFromCache) noexcept(false)
+{
+	const uint32_t ret = detail::pickupValue(this->reg(isReadFromCache), Stop::Bit::Pos, Stop::Bit::Mask);
+	return static_cast<uint8_t>(ret);
+}
+
+// RegMap
+LIBBLDCM_INLINE void RegMap::attachShadow(RegMap::Shadow &shadow, const bool isRestore) noexcept(true)
+{
+	this->freqtgt.attachShadow(shadow.freqtgt, isRestore);
+	this->pwmCmp.attachShadow(shadow.pwmCmp, isRestore);
+	this->ctrl.attachShadow(shadow.ctrl, isRestore);
+	this->stat.attachShadow(shadow.stat, isRestore);
+}
+
+LIBBLDCM_INLINE void RegMap::detachShadow() noexcept(true)
+{
+	this->freqtgt.detachShadow();
+	this->pwmCmp.detachShadow();
+	this->ctrl.detachShadow();
+	this->stat.detachShadow();
+}
+
+LIBBLDCM_INLINE const std::shared_ptr<Bus> &RegMap::bus() const noexcept(true)
+{
+	return this->_busPtr;
+}
+
+LIBBLDCM_INLINE void RegMap::retryPolicy(const Register::RetryPolicy &policy) noexcept(true)
+{
+	this->freqtgt.retryPolicy(policy);
+	this->pwmCmp.retryPolicy(policy);
+	this->ctrl.retryPolicy(policy);
+	this->stat.retryPolicy(policy);
+}
+
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef REGISTER_MAP_IMPL_HPP"
@@ -0,0 +1,130 @@
+#ifndef SHADOW_STORE_IMPL_HPP
+#define SHADOW_STORE_IMPL_HPP
+
+#include <libbldcm/config.hpp>
+#include <libbldcm/shadow_store.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <atomic>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace bldcm {
+namespace detail {
+// Utilities
+LIBBLDCM_INLINE std::string errnoMessage(const std::string &msg)
+{
+	return msg + " (" + std::strerror(errno) + ")";
+}
+} // End of "namespace detail"
+
+//========  ShadowStore class ========
+// Public
+LIBBLDCM_INLINE ShadowStore::ShadowStore(const std::string &name, const std::size_t slotNum) noexcept(false)
+	: _fd(-1), _mapAddr(MAP_FAILED), _mapSize(sizeof(Header) + (sizeof(Slot) * slotNum)),
+	  _header(nullptr), _slots(nullptr), _isResumed(false)
+{
+	struct stat st;
+
+	this->_fd = shm_open(name.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+	if (this->_fd < 0) {
+		throw std::runtime_error(detail::errnoMessage("Fail to open shadow store."));
+	}
+
+	// The lock is released automatically even if the owner process crashes.
+	if (flock(this->_fd, LOCK_EX | LOCK_NB) != 0) {
+		close(this->_fd);
+		throw std::runtime_error(detail::errnoMessage("Shadow store is already used by another process."));
+	}
+
+	if ((fstat(this->_fd, &st) != 0) || (ftruncate(this->_fd, static_cast<off_t>(this->_mapSize)) != 0)) {
+		close(this->_fd);
+		throw std::runtime_error(detail::errnoMessage("Fail to resize shadow store."));
+	}
+
+	this->_mapAddr = mmap(nullptr, this->_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->_fd, 0);
+	if (this->_mapAddr == MAP_FAILED) {
+		close(this->_fd);
+		throw std::runtime_error(detail::errnoMessage("Fail to map shadow store."));
+	}
+
+	this->_header = static_cast<Header *>(this->_mapAddr);
+	this->_slots  = reinterpret_cast<Slot *>(static_cast<char *>(this->_mapAddr) + sizeof(Header));
+
+	this->_isResumed = (static_cast<std::size_t>(st.st_size) == this->_mapSize) &&
+	                   (this->_header->magic == _Magic) &&
+	                   (this->_header->layoutVer == _LayoutVer) &&
+	                   (this->_header->slotNum == static_cast<uint32_t>(slotNum));
+
+	if (!this->_isResumed) {
+		this->invalidate();
+	}
+}
+
+LIBBLDCM_INLINE ShadowStore::~ShadowStore()
+{
+	munmap(this->_mapAddr, this->_mapSize);
+	close(this->_fd);
+}
+
+LIBBLDCM_INLINE ShadowStore::Slot &ShadowStore::slot(const uint32_t baseAddr) noexcept(false)
+{
+	Slot *freeSlot = nullptr;
+
+	for (uint32_t i = 0; i < this->_header->slotNum; i++) {
+		Slot &s = this->_slots[i];
+
+		if (s.inUse == 0U) {
+			if (freeSlot == nullptr) {
+				freeSlot = &s;
+			}
+		} else if (s.baseAddr == baseAddr) {
+			return s;
+		}
+	}
+
+	if (freeSlot == nullptr) {
+		throw std::runtime_error("There is no free slot in shadow store.");
+	}
+
+	std::memset(freeSlot, 0, sizeof(Slot));
+	freeSlot->baseAddr = baseAddr;
+	freeSlot->inUse    = 1U;
+
+	return *freeSlot;
+}
+
+LIBBLDCM_INLINE bool ShadowStore::isResumed() const noexcept(true)
+{
+	return this->_isResumed;
+}
+
+LIBBLDCM_INLINE void ShadowStore::invalidate() noexcept(true)
+{
+	const uint32_t slotNum = static_cast<uint32_t>((this->_mapSize - sizeof(Header)) / sizeof(Slot));
+
+	// Magic is written at last so that a torn initialization is never regarded as valid.
+	this->_header->magic = 0U;
+	std::memset(this->_slots, 0, sizeof(Slot) * slotNum);
+	this->_header->layoutVer = _LayoutVer;
+	this->_header->slotNum   = slotNum;
+	this->_header->reserved  = 0U;
+	std::atomic_thread_fence(std::memory_order_release);
+	this->_header->magic     = _Magic;
+}
+
+LIBBLDCM_INLINE void ShadowStore::remove(const std::string &name) noexcept(true)
+{
+	shm_unlink(name.c_str());
+}
+
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef SHADOW_STORE_IMPL_HPP"
@@ -0,0 +1,99 @@
+#ifndef LATENCY_PROFILER_HPP
+#define LATENCY_PROFILER_HPP
+
+#include <libbldcm/types.hpp>
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <ostream>
+#include <chrono>
+
+namespace bldcm {
+class Motor;
+
+// Profiler of response time of mBldcm.
+// While it's attached to Motor, each setpoint write is timestamped and STAT is sampled on caller's thread
+// until the transition, so setters of Motor return after the transition or timeout.
+//  - reflect: Motor::rotationalSpeed() while output is enabled, until STAT.REFLECTEDFREQ is asserted.
+//  - stop   : Motor::outputEnable(false) while rotating, until STAT.STOP is asserted.
+// The transition is accepted only after the flag is seen deasserted, so a flag left asserted by the previous setpoint
+// isn't taken as the transition. It assumes mBldcm deasserts the flag for at least one sample after the write,
+// otherwise the measurement ends with timeout.
+// Setters of profiled motors block for up to Config::timeout, so don't attach profiler to motors used by
+// latency-bounded users like Watchdog, MotorDaemon or FleetRuntime tasks.
+// Latencies are accumulated in histograms per motor, event and speed band.
+// One profiler can be shared by motors used on different threads.
+class LatencyProfiler {
+	public:
+		// Type define
+		struct Config {
+			std::chrono::nanoseconds samplePeriod; // Period of sampling STAT. Zero means back-to-back reads.
+			std::chrono::nanoseconds timeout;      // Give up waiting for the transition after this.
+			Rps                      bandWidth;    // Width of speed band
+			std::chrono::nanoseconds binWidth;     // Width of histogram bin
+			std::size_t              binNum;       // The last bin also holds latencies over the range.
+		};
+
+		enum class Event {
+			reflect,
+			stop
+		};
+
+		struct Histogram {
+			uint32_t baseAddr;
+			Event    event;
+			Rps      bandLow; // Speed band is [bandLow, bandLow + bandWidth).
+			uint64_t count;
+			uint64_t timeoutNum;
+			uint64_t sampleNum; // Number of STAT reads
+			std::chrono::nanoseconds min;
+			std::chrono::nanoseconds max;
+			std::chrono::nanoseconds total;
+			std::vector<uint64_t>    bins;
+		};
+
+		// Constructor/Destructor
+		LatencyProfiler() noexcept(false);
+		explicit LatencyProfiler(const Config &config) noexcept(false);
+		~LatencyProfiler() {}
+
+		LatencyProfiler(const LatencyProfiler &) = delete;
+		LatencyProfiler &operator=(const LatencyProfiler &) = delete;
+
+		// Methods
+		// Sample STAT of motor until the transition of event. writeTime is the time just before the write.
+		void measure(Motor &motor, const Event event, const Rps &speed,
+		             const std::chrono::steady_clock::time_point &writeTime) noexcept(false);
+
+		std::vector<Histogram> histograms() const noexcept(false);
+		void writeCsv(std::ostream &os) const noexcept(false);
+		void reset() noexcept(true);
+
+		const Config &config() const noexcept(true);
+
+		// Materials
+		static const Config DefaultConfig;
+
+	private:
+		// Type define
+		using Key = std::tuple<uint32_t, Event, int64_t>; // Base address, event and band index
+
+		// Members
+		const Config                 _config;
+		mutable std::mutex           _mtx;
+		std::map<Key, Histogram>     _histograms;
+
+		// Methods
+		void _record(const Key &key, const bool isTimeout, const uint64_t sampleNum,
+		             const std::chrono::nanoseconds &latency) noexcept(false);
+};
+} // End of "namespace bldcm"
+
+// Motor is defined after LatencyProfiler, because header-only variant of Motor needs complete LatencyProfiler.
+#include <libbldcm.hpp>
+
+#endif // End of "#ifndef LATENCY_PROFILER_HPP"
+
@@ -0,0 +1,95 @@
+#ifndef MOTOR_CHANNEL_HPP
+#define MOTOR_CHANNEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace bldcm {
+// Shared memory channel between bldcmd and its clients.
+// Commands are sent through a lock-free MPMC ring and status is published through seqlocked area.
+// So clients never issue any syscall to send commands or read status.
+class MotorChannel {
+	public:
+		// Type define
+		enum class Op : uint32_t {
+			rotationalSpeed, // arg0: rotational speed [rps]
+			pwmDuty,         // arg0: duty [%]
+			outputEnable,    // arg0: 0 (disable) or 1 (enable)
+			pwmPeriod,       // arg0: period [ns], arg1: prescaler selection
+			phase            // arg0: phase
+		};
+
+		struct Command {
+			uint32_t motor;
+			Op       op;
+			int64_t  arg0;
+			int64_t  arg1;
+		};
+
+		struct Status {
+			int64_t  rotationalSpeed; // [rps]
+			int64_t  pwmPeriod;       // [ns]
+			int32_t  pwmPrsc;
+			int32_t  pwmDuty;         // [%]
+			int32_t  phase;
+			uint32_t isOutputEnabled;
+			uint32_t isStopping;
+			uint32_t isReflectedFreq;
+			uint32_t errorCount;      // Number of commands failed to apply.
+			uint32_t reserved;
+			uint64_t updateCount;     // Incremented every publishing.
+		};
+
+		// Constructor/Destructor
+		// Create a channel. It's for daemon. Throw if it's owned by another live daemon, and remove it if stale.
+		MotorChannel(const std::string &name, const uint32_t motorNum, const uint32_t ringSize = DefaultRingSize) noexcept(false);
+		// Open an existing channel. It's for clients.
+		explicit MotorChannel(const std::string &name) noexcept(false);
+		~MotorChannel();
+
+		MotorChannel(const MotorChannel &) = delete;
+		MotorChannel &operator=(const MotorChannel &) = delete;
+
+		// Methods for clients
+		bool push(const Command &cmd, uint64_t *ticket = nullptr) noexcept(true); // Return false if ring is full.
+		Status status(const uint32_t motor) const noexcept(false);
+		uint64_t appliedCount() const noexcept(true); // A command is applied if this is greater than its ticket.
+
+		// Methods for daemon
+		bool pop(Command &cmd) noexcept(true);
+		void publish(const uint32_t motor, const Status &status) noexcept(false);
+		void appliedCount(const uint64_t count) noexcept(true);
+
+		uint32_t motorNum() const noexcept(true);
+		uint32_t ringSize() const noexcept(true);
+
+		// Materials
+		static constexpr uint32_t DefaultRingSize = static_cast<uint32_t>(1024U);
+
+	private:
+		// Type define
+		struct Header;
+		struct StatusCell;
+		struct Cell;
+
+		// Members
+		const std::string _name;
+		const bool        _isOwner;
+		int               _fd;
+		void             *_mapAddr;
+		std::size_t       _mapSize;
+		Header           *_header;
+		StatusCell       *_statusCells;
+		Cell             *_cells;
+
+		// Methods
+		void _map(const std::size_t size) noexcept(false);
+		static std::size_t _statusOffset() noexcept(true);
+		static std::size_t _cellOffset(const uint32_t motorNum) noexcept(true);
+		static std::size_t _mapSizeOf(const uint32_t motorNum, const uint32_t ringSize) noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef MOTOR_CHANNEL_HPP"
+
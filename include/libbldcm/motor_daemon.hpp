@@ -0,0 +1,48 @@
+#ifndef MOTOR_DAEMON_HPP
+#define MOTOR_DAEMON_HPP
+
+#include <libbldcm.hpp>
+#include <libbldcm/motor_channel.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+namespace bldcm {
+// Owner of motors which serves clients through MotorChannel.
+// Motor # in commands is the index of motors given to the constructor.
+class MotorDaemon {
+	public:
+		// Constructor/Destructor
+		MotorDaemon(const std::shared_ptr<MotorChannel> &channel, const std::vector<std::shared_ptr<Motor>> &motors) noexcept(false);
+		~MotorDaemon() {}
+
+		// Methods
+		void runOnce() noexcept(true); // Apply received commands and publish status.
+		void run(const std::atomic<bool> &isStopRequested, const std::chrono::microseconds &pollPeriod) noexcept(true);
+
+	private:
+		// Materials
+		static constexpr uint32_t _OpNum = static_cast<uint32_t>(5U);
+
+		// Members
+		std::shared_ptr<MotorChannel>        _channel;
+		std::vector<std::shared_ptr<Motor>>  _motors;
+		std::vector<MotorChannel::Status>    _statuses;
+		std::vector<MotorChannel::Command>   _batch;
+		std::vector<bool>                    _isSuperseded;
+		std::vector<uint32_t>                _laterOp; // Op of the later command to each motor, or _OpNum if none
+		uint64_t                             _appliedCount = 0;
+
+		// Methods
+		void _merge() noexcept(true);
+		void _apply(const MotorChannel::Command &cmd) noexcept(true);
+		void _fetchStatus(const uint32_t motor) noexcept(true);
+		void _pollStatus(const uint32_t motor) noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef MOTOR_DAEMON_HPP"
+
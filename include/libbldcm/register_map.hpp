@@ -1,23 +1,42 @@
 #ifndef REGISTER_MAP_HPP
 #define REGISTER_MAP_HPP
 
+#include <libbldcm/bus.hpp>
+
 #include <libfpgasoc.hpp>
 
 #include <cstdint>
 #include <memory>
 #include <array>
 #include <string>
+#include <chrono>
 
 namespace bldcm {
 class Register {
 	public:
 		// Type define
-		enum class CacheState {
+		enum class CacheState : uint32_t {
 			initialized, // Never read/write register
 			sync,        // Readed/writed register but unmodified.
 			modified     // Modified cache since the last read from register.
 		};
 
+		// Storage of cache. It can be placed on shared memory to persist cache across processes.
+		struct Shadow {
+			uint32_t   regCache;
+			CacheState cacheStatus;
+		};
+
+		// Policy of retrying bus accesses failed with std::range_error.
+		// Deadline is the budget from the start of the access. It fails fast if the next retry, expected to take
+		// as long as the last try, can't finish within the deadline. NoRetry reads no clock.
+		struct RetryPolicy {
+			uint32_t                 maxRetryNum;
+			std::chrono::nanoseconds initialBackoff; // Doubled at each retry
+			std::chrono::nanoseconds maxBackoff;
+			std::chrono::nanoseconds deadline;
+		};
+
 		// Constructor/Destructor
 		virtual ~Register() {}
 
@@ -25,16 +44,45 @@ class Register {
 		void reg(const Register &reg, const bool isOnlyWriteCache = false) noexcept(false);
 		void reg(const uint32_t &val, const bool isOnlyWriteCache = false) noexcept(false);
 		uint32_t reg(const bool isReadFromCache = false) noexcept(false);
+		// Read from cache if it's synchronized within maxAge. Otherwise, read from register.
+		uint32_t reg(const std::chrono::nanoseconds &maxAge) noexcept(false);
 
 		void flushCache() noexcept(false);
 		void updateCache() noexcept(false);
 
 		CacheState cacheStatus() const noexcept(true);
+		uint32_t address() const noexcept(true);
+
+		// Statistics of reads with max age
+		std::chrono::steady_clock::time_point fillTime() const noexcept(true);
+		uint64_t cacheHitNum() const noexcept(true);
+		uint64_t cacheMissNum() const noexcept(true);
+		double   cacheHitRatio() const noexcept(true);
+
+		// If isRestore is true, cache is restored from shadow. Otherwise, current cache is stored to shadow.
+		void attachShadow(Shadow &shadow, const bool isRestore) noexcept(true);
+		void detachShadow() noexcept(true);
+
+		void retryPolicy(const RetryPolicy &policy) noexcept(true);
+		const RetryPolicy &retryPolicy() const noexcept(true);
+		uint64_t retryNum() const noexcept(true);
+
+		// Materials
+		static const RetryPolicy NoRetry; // Default
 
 	protected:
 		// Only subclass can use this.
-		Register(const uint32_t addr, const uint32_t resetVal, Fpgasoc &obj)
-			: _addr(addr), _regCache(resetVal), _cacheStatus(CacheState::initialized), _fpgaObj(obj) {}
+		Register(const uint32_t addr, const uint32_t resetVal, Bus &bus)
+			: _addr(addr), _localShadow{resetVal, CacheState::initialized}, _shadow(&_localShadow), _bus(bus),
+			  _fillTime(std::chrono::steady_clock::time_point::min()), _cacheHitNum(0), _cacheMissNum(0),
+			  _retryPolicy(NoRetry), _retryNum(0) {}
+		// Copied register shares the shadow if it's attached.
+		Register(const Register &other)
+			: _addr(other._addr), _localShadow(*other._shadow),
+			  _shadow((other._shadow == &other._localShadow) ? &_localShadow : other._shadow),
+			  _bus(other._bus), _fillTime(other._fillTime),
+			  _cacheHitNum(other._cacheHitNum), _cacheMissNum(other._cacheMissNum),
+			  _retryPolicy(other._retryPolicy), _retryNum(other._retryNum) {}
 
 		void _forceSetCacheStatus(const CacheState newState) noexcept(true);
 
@@ -43,17 +91,24 @@ class Register {
 
 	private:
 		const uint32_t _addr; // Address based on FPGA LW
-		uint32_t _regCache; // Register cache
-		CacheState _cacheStatus;
-		Fpgasoc &_fpgaObj;
-
+		Shadow  _localShadow; // Used while shadow is not attached.
+		Shadow *_shadow;      // Register cache and its status
+		Bus    &_bus;
+		std::chrono::steady_clock::time_point _fillTime; // When cache was synchronized with register.
+		uint64_t _cacheHitNum;
+		uint64_t _cacheMissNum;
+		RetryPolicy _retryPolicy;
+		uint64_t    _retryNum;
+
+		template<typename Access>
+		void _retry(const Access &access) noexcept(false);
 };
 
 class FreqtgtReg : public Register {
 	public:
 		// Constructor/Destructor
-		FreqtgtReg(Fpgasoc &obj, const uint32_t baseAddr)
-			: Register(baseAddr + _Offset, _ResetVal, obj) {}
+		FreqtgtReg(Bus &bus, const uint32_t baseAddr)
+			: Register(baseAddr + _Offset, _ResetVal, bus) {}
 		~FreqtgtReg() override {}
 
 		// Methods
@@ -77,8 +132,8 @@ class FreqtgtReg : public Register {
 class PwmCmpReg : public Register {
 	public:
 		// Constructor/Destructor
-		PwmCmpReg(Fpgasoc &obj, const uint32_t baseAddr)
-			: Register(baseAddr + _Offset, _ResetVal, obj) {}
+		PwmCmpReg(Bus &bus, const uint32_t baseAddr)
+			: Register(baseAddr + _Offset, _ResetVal, bus) {}
 		~PwmCmpReg() override {}
 
 		// Methods
@@ -102,8 +157,8 @@ class PwmCmpReg : public Register {
 class CtrlReg : public Register {
 	public:
 		// Constructor/Destructor
-		CtrlReg(Fpgasoc &obj, const uint32_t baseAddr)
-			: Register(baseAddr + _Offset, _ResetVal, obj) {}
+		CtrlReg(Bus &bus, const uint32_t baseAddr)
+			: Register(baseAddr + _Offset, _ResetVal, bus) {}
 		~CtrlReg() override {}
 
 		// Methods
@@ -178,8 +233,8 @@ class CtrlReg : public Register {
 class StatReg : public Register {
 	public:
 		// Constructor/Destructor
-		StatReg(Fpgasoc &obj, const uint32_t baseAddr)
-			: Register(baseAddr + _Offset, _ResetVal, obj) {}
+		StatReg(Bus &bus, const uint32_t baseAddr)
+			: Register(baseAddr + _Offset, _ResetVal, bus) {}
 		~StatReg() override {}
 
 		// Methods
@@ -244,15 +299,32 @@ class StatReg : public Register {
 
 class RegMap {
 	public: 
+		// Type define
+		struct Shadow {
+			Register::Shadow freqtgt;
+			Register::Shadow pwmCmp;
+			Register::Shadow ctrl;
+			Register::Shadow stat;
+		};
+
 		// Constructor/Destructor
 		RegMap(const std::shared_ptr<Fpgasoc> &ptr, const uint32_t baseAddr)
-			: _fpgaObjPtr(ptr),
-		          freqtgt(*_fpgaObjPtr, baseAddr), pwmCmp(*_fpgaObjPtr, baseAddr),
-		          ctrl(*_fpgaObjPtr, baseAddr), stat(*_fpgaObjPtr, baseAddr) {}
+			: RegMap(std::make_shared<FpgasocBus>(ptr), baseAddr) {}
+		RegMap(const std::shared_ptr<Bus> &ptr, const uint32_t baseAddr)
+			: _busPtr(ptr),
+		          freqtgt(*_busPtr, baseAddr), pwmCmp(*_busPtr, baseAddr),
+		          ctrl(*_busPtr, baseAddr), stat(*_busPtr, baseAddr) {}
 		~RegMap() {}
 
+		// Methods
+		void attachShadow(Shadow &shadow, const bool isRestore) noexcept(true);
+		void detachShadow() noexcept(true);
+
+		const std::shared_ptr<Bus> &bus() const noexcept(true);
+		void retryPolicy(const Register::RetryPolicy &policy) noexcept(true); // Set to all registers.
+
 	private:
-		std::shared_ptr<Fpgasoc> _fpgaObjPtr;
+		std::shared_ptr<Bus> _busPtr;
 
 	public:
 		// Registers
@@ -264,5 +336,9 @@ class RegMap {
 };
 } // End of "namespace bldcm"
 
+#ifdef LIBBLDCM_HEADER_ONLY
+#include <libbldcm/impl/register_map_impl.hpp>
+#endif
+
 #endif // End of "#ifndef REGISTER_MAP_HPP"
 
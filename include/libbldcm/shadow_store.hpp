@@ -0,0 +1,73 @@
+#ifndef SHADOW_STORE_HPP
+#define SHADOW_STORE_HPP
+
+#include <libbldcm/register_map.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace bldcm {
+// Named shared memory segment to persist register caches and Motor's cached values.
+// A restarted process can reattach to it and resume motors without full re-initialization.
+// Only one process can open the same segment at the same time.
+class ShadowStore {
+	public:
+		// Type define
+		struct Slot {
+			uint32_t       inUse;
+			uint32_t       baseAddr;
+			int64_t        clkFq;    // [Hz]
+			RegMap::Shadow regs;
+			int32_t        relCnt;   // Negative value means invalid.
+			int32_t        deadtime; // Negative value means invalid.
+			int32_t        pwmDuty;  // Negative value means invalid.
+			uint32_t       isValid;  // Non-zero after the motor owning this slot is initialized.
+		};
+
+		// Constructor/Destructor
+		explicit ShadowStore(const std::string &name, const std::size_t slotNum = DefaultSlotNum) noexcept(false);
+		~ShadowStore();
+
+		ShadowStore(const ShadowStore &) = delete;
+		ShadowStore &operator=(const ShadowStore &) = delete;
+
+		// Methods
+		Slot &slot(const uint32_t baseAddr) noexcept(false); // Find the slot for baseAddr or allocate new one.
+		bool isResumed() const noexcept(true); // Whether valid segment existed at opening.
+		void invalidate() noexcept(true);
+
+		static void remove(const std::string &name) noexcept(true);
+
+		// Materials
+		static constexpr std::size_t DefaultSlotNum = 32;
+
+	private:
+		// Type define
+		struct Header {
+			uint32_t magic;
+			uint32_t layoutVer;
+			uint32_t slotNum;
+			uint32_t reserved;
+		};
+
+		// Materials
+		static constexpr uint32_t _Magic     = static_cast<uint32_t>(0x4D43444CU); // "LDCM"
+		static constexpr uint32_t _LayoutVer = static_cast<uint32_t>(sizeof(Header) + sizeof(Slot));
+
+		// Members
+		int         _fd;
+		void       *_mapAddr;
+		std::size_t _mapSize;
+		Header     *_header;
+		Slot       *_slots;
+		bool        _isResumed;
+};
+} // End of "namespace bldcm"
+
+#ifdef LIBBLDCM_HEADER_ONLY
+#include <libbldcm/impl/shadow_store_impl.hpp>
+#endif
+
+#endif // End of "#ifndef SHADOW_STORE_HPP"
+
@@ -0,0 +1,67 @@
+#ifndef SIM_BUS_HPP
+#define SIM_BUS_HPP
+
+#include <libbldcm/bus.hpp>
+
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace bldcm {
+// In-memory backend simulating mBldcm IPs. It's for running software without HW.
+class SimBus : public Bus {
+	public:
+		// Type define
+		struct Config {
+			uint8_t relCnt   = static_cast<uint8_t>(1U);
+			uint8_t deadtime = static_cast<uint8_t>(0U);
+			std::chrono::nanoseconds reflectLatency = std::chrono::nanoseconds(0); // From setpoint to STAT.REFLECTEDFREQ.
+			std::chrono::nanoseconds stopLatency    = std::chrono::nanoseconds(0); // From output disable to STAT.STOP.
+			std::chrono::nanoseconds accessLatency  = std::chrono::nanoseconds(0); // Busy time of each access.
+		};
+
+		// Constructor/Destructor
+		SimBus() {}
+		~SimBus() override {}
+
+		// Methods
+		void addDevice(const uint32_t baseAddr) noexcept(false);
+		void addDevice(const uint32_t baseAddr, const Config &config) noexcept(false);
+
+		uint32_t read32(const uint32_t addr) noexcept(false) override;
+		void write32(const uint32_t addr, const uint32_t val) noexcept(false) override;
+
+		uint64_t accessCount() const noexcept(true);
+
+	private:
+		// Type define
+		using Clock = std::chrono::steady_clock;
+
+		struct Device {
+			Config            config;
+			uint32_t          freqtgt;
+			uint32_t          pwmCmp;
+			uint32_t          ctrl;
+			bool              isRunning;
+			Clock::time_point reflectAt; // REFLECTEDFREQ asserts from this time while running.
+			Clock::time_point stopAt;    // STOP asserts from this time while not running.
+		};
+
+		// Materials
+		static constexpr uint32_t _RegionSize = static_cast<uint32_t>(0x10U);
+
+		// Members
+		mutable std::mutex           _mtx;
+		std::map<uint32_t, Device>   _devices; // Key is base address.
+		uint64_t                     _accessCount = 0;
+
+		// Methods
+		Device &_device(const uint32_t addr, uint32_t &offset) noexcept(false);
+		void _updateRunning(Device &dev, const Clock::time_point &now) noexcept(true);
+		void _busyWait(const Device &dev) const noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef SIM_BUS_HPP"
+
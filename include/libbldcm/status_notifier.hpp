@@ -0,0 +1,150 @@
+#ifndef STATUS_NOTIFIER_HPP
+#define STATUS_NOTIFIER_HPP
+
+#include <libbldcm.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>
+
+namespace bldcm {
+// Source of interrupts from mBldcm.
+class IrqSource {
+	public:
+		// Type define
+		using Clock = std::chrono::steady_clock;
+
+		// Constructor/Destructor
+		virtual ~IrqSource() {}
+
+		// Methods
+		virtual int fd() const noexcept(true) = 0; // Readable when interrupt is pending.
+		// Consume pending interrupt and re-arm. Return the time when the interrupt was raised.
+		virtual Clock::time_point acknowledge() noexcept(false) = 0;
+};
+
+// Interrupt of UIO device (e.g. /dev/uio0).
+class UioIrqSource : public IrqSource {
+	public:
+		// Constructor/Destructor
+		explicit UioIrqSource(const std::string &devPath) noexcept(false);
+		~UioIrqSource() override;
+
+		UioIrqSource(const UioIrqSource &) = delete;
+		UioIrqSource &operator=(const UioIrqSource &) = delete;
+
+		// Methods
+		int fd() const noexcept(true) override;
+		Clock::time_point acknowledge() noexcept(false) override;
+
+	private:
+		int _fd;
+};
+
+// Stand-in of interrupt driven by eventfd. It's for running without HW.
+class EventFdIrqSource : public IrqSource {
+	public:
+		// Constructor/Destructor
+		EventFdIrqSource() noexcept(false);
+		~EventFdIrqSource() override;
+
+		EventFdIrqSource(const EventFdIrqSource &) = delete;
+		EventFdIrqSource &operator=(const EventFdIrqSource &) = delete;
+
+		// Methods
+		int fd() const noexcept(true) override;
+		Clock::time_point acknowledge() noexcept(false) override;
+
+		void raise() noexcept(true); // It can be called from any thread.
+
+	private:
+		int _fd;
+		std::atomic<Clock::rep> _raisedAt;
+};
+
+// Notify STAT.STOP/REFLECTEDFREQ edges of subscribed motors.
+// STAT is read only when the IRQ source signals a change.
+// While a motor is subscribed, its STAT must not be read from other threads.
+// Callbacks are called without lock, so they can call other methods.
+// unsubscribe() waits for callbacks in flight, so the motor can be destroyed after it returns. So it must not be
+// called while holding a lock which callbacks take. Called from a callback, it drops pending edges of the motor.
+class StatusNotifier {
+	public:
+		// Type define
+		enum class Edge {
+			stopAsserted,
+			stopDeasserted,
+			reflectedFreqAsserted,
+			reflectedFreqDeasserted
+		};
+
+		using Callback = std::function<void(Motor &motor, const Edge edge)>;
+
+		struct Stats {
+			uint64_t irqNum;
+			uint64_t edgeNum;
+			std::chrono::nanoseconds minLatency; // From raising interrupt to the end of callbacks.
+			std::chrono::nanoseconds maxLatency;
+			std::chrono::nanoseconds totalLatency;
+		};
+
+		// Constructor/Destructor
+		explicit StatusNotifier(const std::shared_ptr<IrqSource> &source) noexcept(false);
+		~StatusNotifier();
+
+		StatusNotifier(const StatusNotifier &) = delete;
+		StatusNotifier &operator=(const StatusNotifier &) = delete;
+
+		// Methods
+		void subscribe(Motor &motor, const Callback &callback) noexcept(false);
+		void unsubscribe(const Motor &motor) noexcept(true);
+
+		void start() noexcept(false);
+		void stop() noexcept(true);
+
+		Stats stats() const noexcept(true);
+		// Error which stopped notification thread. Null while it's running or stopped by stop().
+		std::exception_ptr exception() const noexcept(true);
+
+	private:
+		// Type define
+		struct Subscriber {
+			Motor         *motor;
+			Callback       callback;
+			Motor::Status  lastStatus;
+		};
+
+		struct Notification {
+			Motor   *motor;
+			Callback callback;
+			Edge     edge;
+		};
+
+		// Members
+		std::shared_ptr<IrqSource> _source;
+		int                        _stopFd;
+		std::thread                _thread;
+		mutable std::mutex         _mtx;
+		std::condition_variable    _dispatchCv;
+		bool                       _isDispatching = false; // Callbacks of a pass are in flight.
+		std::vector<Subscriber>    _subscribers;
+		Stats                      _stats;
+		std::exception_ptr         _exception;
+		std::vector<Notification>  _notifications; // Used only on notification thread.
+
+		// Methods
+		void _run() noexcept(true);
+		void _dispatch(const IrqSource::Clock::time_point &raisedAt) noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef STATUS_NOTIFIER_HPP"
+
@@ -0,0 +1,33 @@
+#ifndef TYPES_HPP
+#define TYPES_HPP
+
+#include <cstdint>
+#include <chrono>
+#include <ratio>
+
+namespace bldcm {
+
+// Types
+using Rps = std::chrono::duration< int64_t, std::ratio<1> >;
+using Rpm = std::chrono::duration< int64_t, std::ratio<1, 60> >;
+
+template<typename RSConverted, typename RSBase>
+constexpr RSConverted rotationalSpeed_cast(const RSBase &rs)
+{
+	return std::chrono::duration_cast<RSConverted>(rs);
+}
+
+using Hz  = std::chrono::duration< int64_t, std::ratio<1> >;
+using KHz = std::chrono::duration< int64_t, std::ratio<1000> >;
+using MHz = std::chrono::duration< int64_t, std::ratio<1000000> >;
+
+template<typename ClkFqConverted, typename ClkFqBase>
+constexpr ClkFqConverted clockFreq_cast(const ClkFqBase &clkFq)
+{
+	return std::chrono::duration_cast<ClkFqConverted>(clkFq);
+}
+
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef TYPES_HPP"
+
@@ -0,0 +1,107 @@
+#ifndef WATCHDOG_HPP
+#define WATCHDOG_HPP
+
+#include <libbldcm.hpp>
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+namespace bldcm {
+// Watchdog disabling output of motors which stall or don't reflect FREQTGT.
+// A motor is expected to rotate while FREQTGT is non-zero and CTRL.EN is enabled in its caches.
+// Each pass reads STAT of each watched motor only once.
+// Watched motors are accessed from the watchdog thread, so other threads must hold lock() to use them.
+class Watchdog {
+	public:
+		// Type define
+		struct Config {
+			std::chrono::nanoseconds checkPeriod;    // Bound of detection latency together with time of a pass.
+			std::chrono::nanoseconds reflectTimeout; // STAT.REFLECTEDFREQ must be asserted within this after setpoint.
+			std::chrono::nanoseconds stallTimeout;   // STAT.STOP must not be held this long while rotating is expected.
+		};
+
+		enum class Fault {
+			stall,
+			noReflect
+		};
+
+		using FaultCallback = std::function<void(Motor &motor, const Fault fault)>;
+
+		struct Stats {
+			uint64_t passNum;
+			uint64_t faultNum;
+			std::chrono::nanoseconds minDetection; // From the time fault condition is met to disabling output.
+			std::chrono::nanoseconds maxDetection;
+			std::chrono::nanoseconds totalDetection;
+			std::chrono::nanoseconds maxPassTime;
+		};
+
+		// Constructor/Destructor
+		Watchdog() noexcept(false);
+		explicit Watchdog(const Config &config) noexcept(false);
+		~Watchdog();
+
+		Watchdog(const Watchdog &) = delete;
+		Watchdog &operator=(const Watchdog &) = delete;
+
+		// Methods
+		void watch(Motor &motor) noexcept(false);
+		void unwatch(const Motor &motor) noexcept(true);
+		// Called on the thread running the pass after unlocking, so callback can call other methods.
+		void onFault(const FaultCallback &callback) noexcept(true);
+
+		void start() noexcept(false);
+		void stop() noexcept(true);
+		void check() noexcept(true); // Run one pass on caller's thread.
+
+		std::unique_lock<std::mutex> lock() noexcept(false);
+		Stats stats() noexcept(false);
+
+		// Materials
+		static const Config DefaultConfig;
+
+	private:
+		// Type define
+		using Clock = std::chrono::steady_clock;
+
+		struct Entry {
+			Motor            *motor;
+			bool              isRunningExpected;
+			uint32_t          freqtgt;
+			bool              isReflected;  // Reflected since setpoint.
+			bool              isFaulted;    // Output was disabled by watchdog.
+			Clock::time_point setpointTime; // When rotating became expected or FREQTGT was changed.
+			Clock::time_point stopSince;    // When STAT.STOP was asserted while rotating is expected.
+		};
+
+		struct Detected {
+			Motor *motor;
+			Fault  fault;
+		};
+
+		// Members
+		const Config              _config;
+		std::vector<Entry>        _entries;
+		FaultCallback             _callback;
+		std::mutex                _mtx;
+		std::condition_variable   _cv;
+		std::thread               _thread;
+		bool                      _isStopRequested;
+		Stats                     _stats;
+		std::vector<Detected>     _detected; // Faults detected in the pass
+
+		// Methods
+		void _run() noexcept(true);
+		void _checkLocked() noexcept(true);
+		void _notify(std::unique_lock<std::mutex> &lock) noexcept(true); // Call callback without lock.
+		void _fault(Entry &entry, const Fault fault, const Clock::time_point &deadline) noexcept(true);
+};
+} // End of "namespace bldcm"
+
+#endif // End of "#ifndef WATCHDOG_HPP"
+
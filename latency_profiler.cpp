@@ -0,0 +1,3 @@
+#include <libbldcm/latency_profiler.hpp>
+#include <libbldcm/impl/latency_profiler_impl.hpp>
+
@@ -0,0 +1,337 @@
+#include <libbldcm/motor_channel.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <atomic>
+#include <new>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using std::runtime_error;
+using std::invalid_argument;
+using std::out_of_range;
+using std::string;
+using std::size_t;
+using std::atomic;
+using std::memory_order_relaxed;
+using std::memory_order_acquire;
+using std::memory_order_release;
+
+namespace bldcm {
+// Utilities
+static string errnoMessage(const string &msg)
+{
+	return msg + " (" + std::strerror(errno) + ")";
+}
+
+static constexpr size_t alignUp(const size_t val, const size_t align)
+{
+	return ((val + align - 1) / align) * align;
+}
+
+static_assert(atomic<uint64_t>::is_always_lock_free, "64-bit atomic must be lock free to be shared between processes.");
+static_assert(atomic<uint32_t>::is_always_lock_free, "32-bit atomic must be lock free to be shared between processes.");
+
+// Shared memory layout
+static constexpr size_t   CacheLineSize = 64;
+static constexpr size_t   StatusWordNum = (sizeof(MotorChannel::Status) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+static constexpr uint32_t Magic         = static_cast<uint32_t>(0x444D4342U); // "BCMD"
+
+struct MotorChannel::Header {
+	atomic<uint32_t> magic;
+	uint32_t         layoutVer;
+	uint32_t         motorNum;
+	uint32_t         ringSize;
+	alignas(CacheLineSize) atomic<uint64_t> enqueuePos;
+	alignas(CacheLineSize) atomic<uint64_t> dequeuePos;
+	alignas(CacheLineSize) atomic<uint64_t> appliedCount;
+};
+
+struct alignas(CacheLineSize) MotorChannel::StatusCell {
+	atomic<uint32_t> seq; // Odd while the daemon is writing.
+	atomic<uint64_t> words[StatusWordNum];
+};
+
+struct MotorChannel::Cell {
+	atomic<uint64_t> seq;
+	Command          cmd;
+};
+
+static constexpr uint32_t LayoutVer = static_cast<uint32_t>(sizeof(MotorChannel::Status) + sizeof(MotorChannel::Command));
+
+//========  MotorChannel class ========
+// Public
+MotorChannel::MotorChannel(const string &name, const uint32_t motorNum, const uint32_t ringSize) noexcept(false)
+	: _name(name), _isOwner(true), _fd(-1), _mapAddr(MAP_FAILED), _mapSize(0),
+	  _header(nullptr), _statusCells(nullptr), _cells(nullptr)
+{
+	if ((ringSize < static_cast<uint32_t>(2U)) || ((ringSize & (ringSize - 1)) != static_cast<uint32_t>(0U))) {
+		throw invalid_argument("Ring size must be power of 2.");
+	}
+
+	// Owner keeps the channel locked, and the lock is released automatically even if it crashes.
+	// So only a channel which can be locked is regarded as stale one and removed.
+	const int staleFd = shm_open(name.c_str(), O_RDWR, 0);
+	if (staleFd >= 0) {
+		if (flock(staleFd, LOCK_EX | LOCK_NB) != 0) {
+			close(staleFd);
+			throw runtime_error(errnoMessage("Motor channel is already owned by another process."));
+		}
+		shm_unlink(name.c_str());
+		close(staleFd);
+	}
+
+	this->_fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+	if (this->_fd < 0) {
+		throw runtime_error(errnoMessage("Fail to create motor channel."));
+	}
+
+	if (flock(this->_fd, LOCK_EX | LOCK_NB) != 0) {
+		close(this->_fd);
+		throw runtime_error(errnoMessage("Fail to lock motor channel."));
+	}
+
+	if (ftruncate(this->_fd, static_cast<off_t>(_mapSizeOf(motorNum, ringSize))) != 0) {
+		shm_unlink(name.c_str());
+		close(this->_fd);
+		throw runtime_error(errnoMessage("Fail to resize motor channel."));
+	}
+
+	this->_map(_mapSizeOf(motorNum, ringSize));
+
+	this->_header = new (this->_mapAddr) Header();
+	this->_header->layoutVer = LayoutVer;
+	this->_header->motorNum  = motorNum;
+	this->_header->ringSize  = ringSize;
+	this->_header->enqueuePos.store(0, memory_order_relaxed);
+	this->_header->dequeuePos.store(0, memory_order_relaxed);
+	this->_header->appliedCount.store(0, memory_order_relaxed);
+
+	this->_statusCells = reinterpret_cast<StatusCell *>(static_cast<char *>(this->_mapAddr) + _statusOffset());
+	for (uint32_t i = 0; i < motorNum; i++) {
+		StatusCell *cell = new (&this->_statusCells[i]) StatusCell();
+		cell->seq.store(0, memory_order_relaxed);
+		for (auto &word : cell->words) {
+			word.store(0, memory_order_relaxed);
+		}
+	}
+
+	this->_cells = reinterpret_cast<Cell *>(static_cast<char *>(this->_mapAddr) + _cellOffset(motorNum));
+	for (uint32_t i = 0; i < ringSize; i++) {
+		Cell *cell = new (&this->_cells[i]) Cell();
+		cell->seq.store(i, memory_order_relaxed);
+	}
+
+	// Clients regard the channel as valid after magic is written.
+	this->_header->magic.store(Magic, memory_order_release);
+}
+
+MotorChannel::MotorChannel(const string &name) noexcept(false)
+	: _name(name), _isOwner(false), _fd(-1), _mapAddr(MAP_FAILED), _mapSize(0),
+	  _header(nullptr), _statusCells(nullptr), _cells(nullptr)
+{
+	struct stat st;
+
+	this->_fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (this->_fd < 0) {
+		throw runtime_error(errnoMessage("Fail to open motor channel."));
+	}
+
+	if ((fstat(this->_fd, &st) != 0) || (static_cast<size_t>(st.st_size) < sizeof(Header))) {
+		close(this->_fd);
+		throw runtime_error("Motor channel is not initialized.");
+	}
+
+	this->_map(static_cast<size_t>(st.st_size));
+	this->_header = static_cast<Header *>(this->_mapAddr);
+
+	if ((this->_header->magic.load(memory_order_acquire) != Magic) ||
+	    (this->_header->layoutVer != LayoutVer) ||
+	    (_mapSizeOf(this->_header->motorNum, this->_header->ringSize) != this->_mapSize)) {
+		munmap(this->_mapAddr, this->_mapSize);
+		close(this->_fd);
+		throw runtime_error("Motor channel is incompatible or not initialized.");
+	}
+
+	this->_statusCells = reinterpret_cast<StatusCell *>(static_cast<char *>(this->_mapAddr) + _statusOffset());
+	this->_cells = reinterpret_cast<Cell *>(static_cast<char *>(this->_mapAddr) + _cellOffset(this->_header->motorNum));
+}
+
+MotorChannel::~MotorChannel()
+{
+	munmap(this->_mapAddr, this->_mapSize);
+
+	// Unlink before unlocking not to remove a channel created by the next owner.
+	if (this->_isOwner) {
+		shm_unlink(this->_name.c_str());
+	}
+
+	close(this->_fd);
+}
+
+bool MotorChannel::push(const Command &cmd, uint64_t *ticket) noexcept(true)
+{
+	const uint64_t mask = static_cast<uint64_t>(this->_header->ringSize - 1);
+	uint64_t pos = this->_header->enqueuePos.load(memory_order_relaxed);
+	Cell *cell;
+
+	for (;;) {
+		cell = &this->_cells[pos & mask];
+		const uint64_t seq = cell->seq.load(memory_order_acquire);
+		const int64_t  dif = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+		if (dif == 0) {
+			if (this->_header->enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+				break;
+			}
+		} else if (dif < 0) {
+			return false;
+		} else {
+			pos = this->_header->enqueuePos.load(memory_order_relaxed);
+		}
+	}
+
+	cell->cmd = cmd;
+	cell->seq.store(pos + 1, memory_order_release);
+
+	if (ticket != nullptr) {
+		*ticket = pos;
+	}
+
+	return true;
+}
+
+MotorChannel::Status MotorChannel::status(const uint32_t motor) const noexcept(false)
+{
+	uint64_t words[StatusWordNum];
+	uint32_t seqBegin;
+	uint32_t seqEnd;
+	Status   ret;
+
+	if (motor >= this->_header->motorNum) {
+		throw out_of_range("Motor # is out of range.");
+	}
+
+	const StatusCell &cell = this->_statusCells[motor];
+
+	do {
+		seqBegin = cell.seq.load(memory_order_acquire);
+		for (size_t i = 0; i < StatusWordNum; i++) {
+			words[i] = cell.words[i].load(memory_order_relaxed);
+		}
+		std::atomic_thread_fence(memory_order_acquire);
+		seqEnd = cell.seq.load(memory_order_relaxed);
+	} while (((seqBegin & static_cast<uint32_t>(1U)) != static_cast<uint32_t>(0U)) || (seqBegin != seqEnd));
+
+	std::memcpy(&ret, words, sizeof(Status));
+
+	return ret;
+}
+
+uint64_t MotorChannel::appliedCount() const noexcept(true)
+{
+	return this->_header->appliedCount.load(memory_order_acquire);
+}
+
+bool MotorChannel::pop(Command &cmd) noexcept(true)
+{
+	const uint64_t mask = static_cast<uint64_t>(this->_header->ringSize - 1);
+	uint64_t pos = this->_header->dequeuePos.load(memory_order_relaxed);
+	Cell *cell;
+
+	for (;;) {
+		cell = &this->_cells[pos & mask];
+		const uint64_t seq = cell->seq.load(memory_order_acquire);
+		const int64_t  dif = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+
+		if (dif == 0) {
+			if (this->_header->dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+				break;
+			}
+		} else if (dif < 0) {
+			return false;
+		} else {
+			pos = this->_header->dequeuePos.load(memory_order_relaxed);
+		}
+	}
+
+	cmd = cell->cmd;
+	cell->seq.store(pos + mask + 1, memory_order_release);
+
+	return true;
+}
+
+void MotorChannel::publish(const uint32_t motor, const Status &status) noexcept(false)
+{
+	uint64_t words[StatusWordNum] = {};
+
+	if (motor >= this->_header->motorNum) {
+		throw out_of_range("Motor # is out of range.");
+	}
+
+	StatusCell &cell = this->_statusCells[motor];
+	const uint32_t seq = cell.seq.load(memory_order_relaxed);
+
+	std::memcpy(words, &status, sizeof(Status));
+
+	cell.seq.store(seq + 1, memory_order_relaxed);
+	std::atomic_thread_fence(memory_order_release);
+	for (size_t i = 0; i < StatusWordNum; i++) {
+		cell.words[i].store(words[i], memory_order_relaxed);
+	}
+	cell.seq.store(seq + 2, memory_order_release);
+}
+
+void MotorChannel::appliedCount(const uint64_t count) noexcept(true)
+{
+	this->_header->appliedCount.store(count, memory_order_release);
+}
+
+uint32_t MotorChannel::motorNum() const noexcept(true)
+{
+	return this->_header->motorNum;
+}
+
+uint32_t MotorChannel::ringSize() const noexcept(true)
+{
+	return this->_header->ringSize;
+}
+
+// Private
+void MotorChannel::_map(const size_t size) noexcept(false)
+{
+	this->_mapSize = size;
+	this->_mapAddr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->_fd, 0);
+
+	if (this->_mapAddr == MAP_FAILED) {
+		if (this->_isOwner) {
+			shm_unlink(this->_name.c_str());
+		}
+		close(this->_fd);
+		throw runtime_error(errnoMessage("Fail to map motor channel."));
+	}
+}
+
+size_t MotorChannel::_statusOffset() noexcept(true)
+{
+	return alignUp(sizeof(Header), CacheLineSize);
+}
+
+size_t MotorChannel::_cellOffset(const uint32_t motorNum) noexcept(true)
+{
+	return alignUp(_statusOffset() + (sizeof(StatusCell) * motorNum), CacheLineSize);
+}
+
+size_t MotorChannel::_mapSizeOf(const uint32_t motorNum, const uint32_t ringSize) noexcept(true)
+{
+	return _cellOffset(motorNum) + (sizeof(Cell) * ringSize);
+}
+
+} // End of "namespace bldcm"
+
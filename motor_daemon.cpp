@@ -0,0 +1,185 @@
+#include <libbldcm/motor_daemon.hpp>
+#include <libbldcm/motor_channel.hpp>
+#include <libbldcm.hpp>
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+
+using std::shared_ptr;
+using std::vector;
+using std::atomic;
+using std::invalid_argument;
+using std::chrono::nanoseconds;
+using std::chrono::microseconds;
+
+namespace bldcm {
+
+//========  MotorDaemon class ========
+// Public
+MotorDaemon::MotorDaemon(const shared_ptr<MotorChannel> &channel, const vector<shared_ptr<Motor>> &motors) noexcept(false)
+	: _channel(channel), _motors(motors), _statuses(motors.size(), MotorChannel::Status()),
+	  _laterOp(motors.size(), _OpNum)
+{
+	if (motors.size() > static_cast<size_t>(channel->motorNum())) {
+		throw invalid_argument("The number of motors exceeds the capacity of the channel.");
+	}
+
+	this->_batch.reserve(channel->ringSize());
+	this->_isSuperseded.reserve(channel->ringSize());
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(this->_motors.size()); i++) {
+		this->_fetchStatus(i);
+		this->_channel->publish(i, this->_statuses[i]);
+	}
+}
+
+void MotorDaemon::runOnce() noexcept(true)
+{
+	MotorChannel::Command cmd;
+
+	this->_batch.clear();
+	while ((this->_batch.size() < this->_batch.capacity()) && this->_channel->pop(cmd)) {
+		this->_batch.push_back(cmd);
+	}
+
+	this->_merge();
+
+	for (size_t i = 0; i < this->_batch.size(); i++) {
+		if (!this->_isSuperseded[i]) {
+			this->_apply(this->_batch[i]);
+		}
+	}
+
+	this->_appliedCount += this->_batch.size();
+	this->_channel->appliedCount(this->_appliedCount);
+
+	for (uint32_t i = 0; i < static_cast<uint32_t>(this->_motors.size()); i++) {
+		this->_pollStatus(i);
+		this->_statuses[i].updateCount++;
+		this->_channel->publish(i, this->_statuses[i]);
+	}
+}
+
+void MotorDaemon::run(const atomic<bool> &isStopRequested, const microseconds &pollPeriod) noexcept(true)
+{
+	auto nextTime = std::chrono::steady_clock::now();
+
+	while (!isStopRequested.load()) {
+		this->runOnce();
+		nextTime += pollPeriod;
+		std::this_thread::sleep_until(nextTime);
+	}
+}
+
+// Private
+void MotorDaemon::_merge() noexcept(true)
+{
+	// A command is superseded only by the next command to the same motor with the same op.
+	// Commands with other ops in between keep their order, e.g. disable, period, enable.
+	// Phase commands are never merged because each of them steps commutation.
+	this->_isSuperseded.assign(this->_batch.size(), false);
+	std::fill(this->_laterOp.begin(), this->_laterOp.end(), _OpNum);
+
+	for (size_t i = this->_batch.size(); i > 0; i--) {
+		const MotorChannel::Command &cmd = this->_batch[i - 1];
+		const uint32_t op = static_cast<uint32_t>(cmd.op);
+
+		if ((cmd.motor >= this->_motors.size()) || (op >= _OpNum)) {
+			continue;
+		}
+
+		uint32_t &laterOp = this->_laterOp[cmd.motor];
+
+		if ((cmd.op != MotorChannel::Op::phase) && (laterOp == op)) {
+			this->_isSuperseded[i - 1] = true;
+		}
+		laterOp = op;
+	}
+}
+
+void MotorDaemon::_apply(const MotorChannel::Command &cmd) noexcept(true)
+{
+	if (cmd.motor >= this->_motors.size()) {
+		return;
+	}
+
+	Motor &motor = *this->_motors[cmd.motor];
+	MotorChannel::Status &status = this->_statuses[cmd.motor];
+
+	try {
+		switch (cmd.op) {
+			case MotorChannel::Op::rotationalSpeed:
+				motor.rotationalSpeed(Rps(cmd.arg0));
+				status.rotationalSpeed = cmd.arg0;
+				break;
+			case MotorChannel::Op::pwmDuty:
+				motor.pwmDuty(static_cast<int>(cmd.arg0));
+				status.pwmDuty = static_cast<int32_t>(cmd.arg0);
+				break;
+			case MotorChannel::Op::outputEnable:
+				motor.outputEnable(cmd.arg0 != 0);
+				status.isOutputEnabled = (cmd.arg0 != 0) ? 1U : 0U;
+				break;
+			case MotorChannel::Op::pwmPeriod:
+				motor.pwmPeriod(nanoseconds(cmd.arg0), static_cast<int>(cmd.arg1));
+				status.pwmPeriod = cmd.arg0;
+				status.pwmPrsc   = static_cast<int32_t>(cmd.arg1);
+				break;
+			case MotorChannel::Op::phase:
+				motor.phase(static_cast<int>(cmd.arg0));
+				status.phase = static_cast<int32_t>(cmd.arg0);
+				break;
+			default:
+				status.errorCount++;
+				break;
+		}
+	} catch (...) {
+		status.errorCount++;
+	}
+}
+
+void MotorDaemon::_fetchStatus(const uint32_t motor) noexcept(true)
+{
+	Motor &m = *this->_motors[motor];
+	MotorChannel::Status &status = this->_statuses[motor];
+
+	status.pwmDuty = -1;
+	try {
+		const auto period = m.pwmPeriod<nanoseconds>();
+
+		status.rotationalSpeed = m.rotationalSpeed<Rps>().count();
+		status.pwmPeriod       = period.first.count();
+		status.pwmPrsc         = static_cast<int32_t>(period.second);
+		status.phase           = static_cast<int32_t>(m.phase());
+		status.isOutputEnabled = (m.outputEnable()) ? 1U : 0U;
+		status.pwmDuty         = static_cast<int32_t>(m.pwmDuty());
+	} catch (...) {
+		status.errorCount++;
+	}
+
+	this->_pollStatus(motor);
+}
+
+void MotorDaemon::_pollStatus(const uint32_t motor) noexcept(true)
+{
+	Motor &m = *this->_motors[motor];
+	MotorChannel::Status &status = this->_statuses[motor];
+
+	// The daemon is the only writer, so only STAT has to be polled.
+	try {
+		const Motor::Status stat = m.status();
+		status.isStopping      = (stat.isStopping) ? 1U : 0U;
+		status.isReflectedFreq = (stat.isReflectedFreq) ? 1U : 0U;
+	} catch (...) {
+		status.errorCount++;
+	}
+}
+
+} // End of "namespace bldcm"
+
@@ -0,0 +1,3 @@
+#include <libbldcm/shadow_store.hpp>
+#include <libbldcm/impl/shadow_store_impl.hpp>
+
@@ -0,0 +1,167 @@
+#include <libbldcm/sim_bus.hpp>
+#include <libbldcm/register_map.hpp>
+
+#include <stdexcept>
+#include <mutex>
+#include <chrono>
+
+using std::lock_guard;
+using std::mutex;
+using std::range_error;
+using std::invalid_argument;
+
+namespace bldcm {
+// Utilities
+namespace {
+constexpr uint32_t FreqtgtOffset = static_cast<uint32_t>(0x00000000U);
+constexpr uint32_t PwmCmpOffset  = static_cast<uint32_t>(0x00000004U);
+constexpr uint32_t CtrlOffset    = static_cast<uint32_t>(0x00000008U);
+constexpr uint32_t StatOffset    = static_cast<uint32_t>(0x0000000CU);
+constexpr uint32_t CtrlResetVal  = static_cast<uint32_t>(0x0FFFF000U);
+}
+
+//========  SimBus class ========
+// Public
+void SimBus::addDevice(const uint32_t baseAddr) noexcept(false)
+{
+	this->addDevice(baseAddr, Config());
+}
+
+void SimBus::addDevice(const uint32_t baseAddr, const Config &config) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	Device dev;
+
+	if (this->_devices.count(baseAddr) != 0) {
+		throw invalid_argument("Device is already added at the base address.");
+	}
+
+	dev.config    = config;
+	dev.freqtgt   = static_cast<uint32_t>(0U);
+	dev.pwmCmp    = static_cast<uint32_t>(0U);
+	dev.ctrl      = CtrlResetVal;
+	dev.isRunning = false;
+	dev.reflectAt = Clock::time_point::min();
+	dev.stopAt    = Clock::time_point::min();
+
+	this->_devices.emplace(baseAddr, dev);
+}
+
+uint32_t SimBus::read32(const uint32_t addr) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	uint32_t offset;
+	Device &dev = this->_device(addr, offset);
+	uint32_t ret = static_cast<uint32_t>(0U);
+
+	this->_busyWait(dev);
+	this->_accessCount++;
+
+	if (offset == FreqtgtOffset) {
+		ret = dev.freqtgt;
+	} else if (offset == PwmCmpOffset) {
+		ret = dev.pwmCmp;
+	} else if (offset == CtrlOffset) {
+		ret = dev.ctrl;
+	} else if (offset == StatOffset) {
+		const Clock::time_point now = Clock::now();
+		const bool isReflected = dev.isRunning && (now >= dev.reflectAt);
+		const bool isStopping  = (!dev.isRunning) && (now >= dev.stopAt);
+
+		ret = (static_cast<uint32_t>(dev.config.relCnt) << StatReg::RelCnt::Bit::Pos) & StatReg::RelCnt::Bit::Mask;
+		ret |= (static_cast<uint32_t>(dev.config.deadtime) << StatReg::Deadtime::Bit::Pos) & StatReg::Deadtime::Bit::Mask;
+		ret |= (isReflected) ? StatReg::Reflectedfreq::Bit::Mask : static_cast<uint32_t>(0U);
+		ret |= (isStopping) ? StatReg::Stop::Bit::Mask : static_cast<uint32_t>(0U);
+	} else {
+		throw range_error("Unaligned access to simulated mBldcm.");
+	}
+
+	return ret;
+}
+
+void SimBus::write32(const uint32_t addr, const uint32_t val) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	uint32_t offset;
+	Device &dev = this->_device(addr, offset);
+	const Clock::time_point now = Clock::now();
+
+	this->_busyWait(dev);
+	this->_accessCount++;
+
+	if (offset == FreqtgtOffset) {
+		dev.freqtgt = val;
+		// New setpoint must be reflected again.
+		dev.reflectAt = now + dev.config.reflectLatency;
+	} else if (offset == PwmCmpOffset) {
+		dev.pwmCmp = val & PwmCmpReg::PwmCmp::Bit::Mask;
+	} else if (offset == CtrlOffset) {
+		uint32_t ctrl = val & (~CtrlReg::WPhase::Bit::Mask);
+
+		// PHASE is updated only when W_PHASE is written.
+		if ((val & CtrlReg::WPhase::Bit::Mask) == static_cast<uint32_t>(0U)) {
+			ctrl = (ctrl & (~CtrlReg::Phase::Bit::Mask)) | (dev.ctrl & CtrlReg::Phase::Bit::Mask);
+		}
+
+		dev.ctrl = ctrl;
+	} else if (offset == StatOffset) {
+		// STAT is read only.
+	} else {
+		throw range_error("Unaligned access to simulated mBldcm.");
+	}
+
+	this->_updateRunning(dev, now);
+}
+
+uint64_t SimBus::accessCount() const noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_accessCount;
+}
+
+// Private
+SimBus::Device &SimBus::_device(const uint32_t addr, uint32_t &offset) noexcept(false)
+{
+	auto itr = this->_devices.upper_bound(addr);
+
+	if (itr == this->_devices.begin()) {
+		throw range_error("No simulated mBldcm at the address.");
+	}
+
+	--itr;
+	offset = addr - itr->first;
+
+	if (offset >= _RegionSize) {
+		throw range_error("No simulated mBldcm at the address.");
+	}
+
+	return itr->second;
+}
+
+void SimBus::_updateRunning(Device &dev, const Clock::time_point &now) noexcept(true)
+{
+	const bool isEnabled = ((dev.ctrl & CtrlReg::En::Bit::Mask) != static_cast<uint32_t>(0U));
+	const bool isRunning = isEnabled && (dev.freqtgt != static_cast<uint32_t>(0U));
+
+	if (isRunning && (!dev.isRunning)) {
+		dev.reflectAt = now + dev.config.reflectLatency;
+	} else if ((!isRunning) && dev.isRunning) {
+		dev.stopAt = now + dev.config.stopLatency;
+	}
+
+	dev.isRunning = isRunning;
+}
+
+void SimBus::_busyWait(const Device &dev) const noexcept(true)
+{
+	if (dev.config.accessLatency > std::chrono::nanoseconds::zero()) {
+		const Clock::time_point until = Clock::now() + dev.config.accessLatency;
+
+		while (Clock::now() < until) {
+			// Busy wait to model bus latency.
+		}
+	}
+}
+
+} // End of "namespace bldcm"
+
@@ -0,0 +1,304 @@
+#include <libbldcm/status_notifier.hpp>
+#include <libbldcm.hpp>
+
+#include <memory>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using std::shared_ptr;
+using std::string;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::runtime_error;
+using std::chrono::nanoseconds;
+using std::chrono::duration_cast;
+
+namespace bldcm {
+// Utilities
+static string errnoMessage(const string &msg)
+{
+	return msg + " (" + std::strerror(errno) + ")";
+}
+
+//========  UioIrqSource class ========
+// Public
+UioIrqSource::UioIrqSource(const string &devPath) noexcept(false)
+	: _fd(open(devPath.c_str(), O_RDWR | O_CLOEXEC))
+{
+	const uint32_t enable = static_cast<uint32_t>(1U);
+
+	if (this->_fd < 0) {
+		throw runtime_error(errnoMessage("Fail to open UIO device."));
+	}
+
+	// Arm interrupt at first.
+	if (write(this->_fd, &enable, sizeof(enable)) != static_cast<ssize_t>(sizeof(enable))) {
+		close(this->_fd);
+		throw runtime_error(errnoMessage("Fail to enable interrupt of UIO device."));
+	}
+}
+
+UioIrqSource::~UioIrqSource()
+{
+	close(this->_fd);
+}
+
+int UioIrqSource::fd() const noexcept(true)
+{
+	return this->_fd;
+}
+
+IrqSource::Clock::time_point UioIrqSource::acknowledge() noexcept(false)
+{
+	const uint32_t enable = static_cast<uint32_t>(1U);
+	uint32_t count;
+
+	if (read(this->_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+		throw runtime_error(errnoMessage("Fail to read interrupt of UIO device."));
+	}
+
+	const Clock::time_point now = Clock::now();
+
+	// Re-arm before STAT is read so that no edge is missed.
+	if (write(this->_fd, &enable, sizeof(enable)) != static_cast<ssize_t>(sizeof(enable))) {
+		throw runtime_error(errnoMessage("Fail to re-enable interrupt of UIO device."));
+	}
+
+	return now;
+}
+
+//========  EventFdIrqSource class ========
+// Public
+EventFdIrqSource::EventFdIrqSource() noexcept(false)
+	: _fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), _raisedAt(0)
+{
+	if (this->_fd < 0) {
+		throw runtime_error(errnoMessage("Fail to create eventfd."));
+	}
+}
+
+EventFdIrqSource::~EventFdIrqSource()
+{
+	close(this->_fd);
+}
+
+int EventFdIrqSource::fd() const noexcept(true)
+{
+	return this->_fd;
+}
+
+IrqSource::Clock::time_point EventFdIrqSource::acknowledge() noexcept(false)
+{
+	uint64_t count;
+
+	if ((read(this->_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) && (errno != EAGAIN)) {
+		throw runtime_error(errnoMessage("Fail to read eventfd."));
+	}
+
+	return Clock::time_point(Clock::duration(this->_raisedAt.load()));
+}
+
+void EventFdIrqSource::raise() noexcept(true)
+{
+	const uint64_t val = 1;
+
+	this->_raisedAt.store(Clock::now().time_since_epoch().count());
+	static_cast<void>(write(this->_fd, &val, sizeof(val)));
+}
+
+//========  StatusNotifier class ========
+// Public
+StatusNotifier::StatusNotifier(const shared_ptr<IrqSource> &source) noexcept(false)
+	: _source(source), _stopFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+	  _stats{0, 0, nanoseconds::max(), nanoseconds::zero(), nanoseconds::zero()}
+{
+	if (this->_stopFd < 0) {
+		throw runtime_error(errnoMessage("Fail to create eventfd."));
+	}
+}
+
+StatusNotifier::~StatusNotifier()
+{
+	this->stop();
+	close(this->_stopFd);
+}
+
+void StatusNotifier::subscribe(Motor &motor, const Callback &callback) noexcept(false)
+{
+	const Motor::Status status = motor.status();
+	lock_guard<mutex> lock(this->_mtx);
+
+	this->_subscribers.push_back(Subscriber{&motor, callback, status});
+}
+
+void StatusNotifier::unsubscribe(const Motor &motor) noexcept(true)
+{
+	unique_lock<mutex> lock(this->_mtx);
+	auto &subs = this->_subscribers;
+
+	subs.erase(std::remove_if(subs.begin(), subs.end(), [&motor](const Subscriber &s) { return s.motor == &motor; }), subs.end());
+
+	if (std::this_thread::get_id() == this->_thread.get_id()) {
+		// Called from a callback. The motor may be destroyed after this, so its pending edges are dropped.
+		for (Notification &n : this->_notifications) {
+			if (n.motor == &motor) {
+				n.motor = nullptr;
+			}
+		}
+	} else {
+		// Wait for the pass which may be calling back the motor.
+		this->_dispatchCv.wait(lock, [this] { return !this->_isDispatching; });
+	}
+}
+
+void StatusNotifier::start() noexcept(false)
+{
+	if (!this->_thread.joinable()) {
+		uint64_t count;
+		// Clear stop request of the last run.
+		static_cast<void>(read(this->_stopFd, &count, sizeof(count)));
+		{
+			lock_guard<mutex> lock(this->_mtx);
+			this->_exception = nullptr;
+		}
+		this->_thread = std::thread(&StatusNotifier::_run, this);
+	}
+}
+
+void StatusNotifier::stop() noexcept(true)
+{
+	const uint64_t val = 1;
+
+	if (this->_thread.joinable()) {
+		static_cast<void>(write(this->_stopFd, &val, sizeof(val)));
+		this->_thread.join();
+	}
+}
+
+StatusNotifier::Stats StatusNotifier::stats() const noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_stats;
+}
+
+std::exception_ptr StatusNotifier::exception() const noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_exception;
+}
+
+// Private
+void StatusNotifier::_run() noexcept(true)
+{
+	struct pollfd fds[2];
+
+	fds[0].fd = this->_source->fd();
+	fds[0].events = POLLIN;
+	fds[1].fd = this->_stopFd;
+	fds[1].events = POLLIN;
+
+	try {
+		for (;;) {
+			if (poll(fds, 2, -1) < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				throw runtime_error(errnoMessage("Fail to wait interrupt."));
+			}
+
+			if ((fds[1].revents & POLLIN) != 0) {
+				break;
+			}
+
+			if ((fds[0].revents & POLLIN) != 0) {
+				this->_dispatch(this->_source->acknowledge());
+			}
+		}
+	} catch (...) {
+		// Keep the error visible to users instead of stopping silently.
+		lock_guard<mutex> lock(this->_mtx);
+		this->_exception = std::current_exception();
+	}
+}
+
+void StatusNotifier::_dispatch(const IrqSource::Clock::time_point &raisedAt) noexcept(true)
+{
+	auto &notifications = this->_notifications;
+
+	notifications.clear();
+
+	{
+		lock_guard<mutex> lock(this->_mtx);
+
+		this->_isDispatching = true;
+		this->_stats.irqNum++;
+
+		for (Subscriber &sub : this->_subscribers) {
+			Motor::Status status;
+
+			try {
+				status = sub.motor->status();
+			} catch (...) {
+				continue;
+			}
+
+			try {
+				if (status.isStopping != sub.lastStatus.isStopping) {
+					notifications.push_back(Notification{sub.motor, sub.callback, (status.isStopping) ? Edge::stopAsserted : Edge::stopDeasserted});
+				}
+				if (status.isReflectedFreq != sub.lastStatus.isReflectedFreq) {
+					notifications.push_back(Notification{sub.motor, sub.callback, (status.isReflectedFreq) ? Edge::reflectedFreqAsserted : Edge::reflectedFreqDeasserted});
+				}
+			} catch (...) {
+				// Edges which can't be queued are dropped.
+			}
+
+			sub.lastStatus = status;
+		}
+
+		this->_stats.edgeNum += notifications.size();
+	}
+
+	// Callbacks are called without lock so that they can subscribe, unsubscribe or get stats.
+	// Indexed loop, because unsubscribe() in callbacks clears motors of pending notifications.
+	for (std::size_t i = 0; i < notifications.size(); i++) {
+		const Notification &n = notifications[i];
+
+		if (n.motor == nullptr) {
+			continue;
+		}
+
+		try {
+			n.callback(*n.motor, n.edge);
+		} catch (...) {
+			// Exceptions from callbacks must not stop notification to others.
+		}
+	}
+
+	const nanoseconds latency = duration_cast<nanoseconds>(IrqSource::Clock::now() - raisedAt);
+
+	{
+		lock_guard<mutex> lock(this->_mtx);
+
+		this->_isDispatching       = false;
+		this->_stats.minLatency    = std::min(this->_stats.minLatency, latency);
+		this->_stats.maxLatency    = std::max(this->_stats.maxLatency, latency);
+		this->_stats.totalLatency += latency;
+	}
+	this->_dispatchCv.notify_all();
+}
+
+} // End of "namespace bldcm"
+
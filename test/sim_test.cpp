@@ -0,0 +1,332 @@
+// Tests of libbldcm on the simulated backend. Each case is run by name from CTest.
+#include <libbldcm.hpp>
+#include <libbldcm/sim_bus.hpp>
+#include <libbldcm/motor_channel.hpp>
+#include <libbldcm/motor_daemon.hpp>
+#include <libbldcm/emergency_stop.hpp>
+#include <libbldcm/commutation_sequencer.hpp>
+#include <libbldcm/duty_dither.hpp>
+#include <libbldcm/fleet_runtime.hpp>
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+#include <functional>
+#include <utility>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <iostream>
+#include <cstdlib>
+
+#include <unistd.h>
+
+using std::shared_ptr;
+using std::make_shared;
+using std::vector;
+using std::string;
+using std::atomic;
+using std::cerr;
+using std::endl;
+using std::chrono::nanoseconds;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+using namespace bldcm;
+
+namespace {
+// Utilities
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed." << endl; \
+			std::exit(EXIT_FAILURE); \
+		} \
+	} while (false)
+
+constexpr uint32_t BaseAddr0 = static_cast<uint32_t>(0x100U);
+constexpr uint32_t BaseAddr1 = static_cast<uint32_t>(0x200U);
+
+// Bus recording writes to check the order of them.
+class RecordingBus : public Bus {
+	public:
+		explicit RecordingBus(const shared_ptr<Bus> &bus) : _bus(bus) {}
+
+		uint32_t read32(const uint32_t addr) noexcept(false) override
+		{
+			return this->_bus->read32(addr);
+		}
+
+		void write32(const uint32_t addr, const uint32_t val) noexcept(false) override
+		{
+			this->writes.push_back(std::make_pair(addr, val));
+			this->_bus->write32(addr, val);
+		}
+
+		vector<std::pair<uint32_t, uint32_t>> writes;
+
+	private:
+		shared_ptr<Bus> _bus;
+};
+
+shared_ptr<SimBus> simBus()
+{
+	shared_ptr<SimBus> sim = make_shared<SimBus>();
+
+	sim->addDevice(BaseAddr0);
+	sim->addDevice(BaseAddr1);
+
+	return sim;
+}
+
+string channelName(const string &name)
+{
+	return "/libbldcm_test_" + name + "_" + std::to_string(getpid());
+}
+
+uint32_t ctrlField(const uint32_t word, const uint32_t mask, const uint32_t pos)
+{
+	return (word & mask) >> pos;
+}
+
+// Test cases
+void channelPushPopStatus()
+{
+	const string name = channelName("channel");
+	MotorChannel owner(name, 2, 4);
+	MotorChannel client(name);
+	MotorChannel::Command cmd;
+	MotorChannel::Status status = {};
+	uint64_t ticket;
+
+	CHECK(client.motorNum() == 2);
+	CHECK(client.ringSize() == 4);
+
+	// Ring is bounded by its size.
+	for (int64_t i = 0; i < 4; i++) {
+		CHECK(client.push(MotorChannel::Command{1, MotorChannel::Op::pwmDuty, i, 0}, &ticket));
+		CHECK(ticket == static_cast<uint64_t>(i));
+	}
+	CHECK(!client.push(MotorChannel::Command{1, MotorChannel::Op::pwmDuty, 4, 0}));
+
+	for (int64_t i = 0; i < 4; i++) {
+		CHECK(owner.pop(cmd));
+		CHECK((cmd.motor == 1) && (cmd.op == MotorChannel::Op::pwmDuty) && (cmd.arg0 == i));
+	}
+	CHECK(!owner.pop(cmd));
+
+	status.rotationalSpeed = 30;
+	status.updateCount     = 7;
+	owner.publish(1, status);
+	owner.appliedCount(4);
+
+	CHECK(client.status(1).rotationalSpeed == 30);
+	CHECK(client.status(1).updateCount == 7);
+	CHECK(client.appliedCount() == 4);
+
+	// A live owner is never taken over.
+	bool isThrown = false;
+	try {
+		MotorChannel another(name, 2, 4);
+	} catch (const std::runtime_error &) {
+		isThrown = true;
+	}
+	CHECK(isThrown);
+}
+
+void daemonApplyMerge()
+{
+	const string name = channelName("daemon");
+	shared_ptr<RecordingBus> bus = make_shared<RecordingBus>(simBus());
+	shared_ptr<Motor> motor = make_shared<Motor>(shared_ptr<Bus>(bus), MHz(50), BaseAddr0);
+	shared_ptr<MotorChannel> channel = make_shared<MotorChannel>(name, 1);
+	MotorChannel client(name);
+
+	motor->pwmPeriod(microseconds(8), 0);
+	motor->pwmDuty(50);
+	motor->outputEnable(true);
+
+	MotorDaemon daemon(channel, {motor});
+
+	// Consecutive commands with the same op are merged.
+	bus->writes.clear();
+	CHECK(client.push(MotorChannel::Command{0, MotorChannel::Op::rotationalSpeed, 10, 0}));
+	CHECK(client.push(MotorChannel::Command{0, MotorChannel::Op::rotationalSpeed, 20, 0}));
+	daemon.runOnce();
+
+	CHECK(client.appliedCount() == 2);
+	CHECK(client.status(0).rotationalSpeed == 20);
+	CHECK(bus->writes.size() == 1);
+
+	// Period must be changed while output is disabled.
+	bus->writes.clear();
+	CHECK(client.push(MotorChannel::Command{0, MotorChannel::Op::outputEnable, 0, 0}));
+	CHECK(client.push(MotorChannel::Command{0, MotorChannel::Op::pwmPeriod, 16000, 1}));
+	CHECK(client.push(MotorChannel::Command{0, MotorChannel::Op::outputEnable, 1, 0}));
+	daemon.runOnce();
+
+	CHECK(client.appliedCount() == 5);
+	CHECK(client.status(0).isOutputEnabled == 1U);
+
+	const uint32_t ctrlAddr = motor->regMap().ctrl.address();
+	vector<uint32_t> ctrlWrites;
+
+	for (const auto &w : bus->writes) {
+		if (w.first == ctrlAddr) {
+			ctrlWrites.push_back(w.second);
+		}
+	}
+
+	CHECK(ctrlWrites.size() == 3);
+	CHECK(ctrlField(ctrlWrites[0], CtrlReg::En::Bit::Mask, CtrlReg::En::Bit::Pos) == CtrlReg::En::Val::Disable);
+	CHECK(ctrlField(ctrlWrites[1], CtrlReg::PwmPrsc::Bit::Mask, CtrlReg::PwmPrsc::Bit::Pos) == 1U);
+	CHECK(ctrlField(ctrlWrites[1], CtrlReg::En::Bit::Mask, CtrlReg::En::Bit::Pos) == CtrlReg::En::Val::Disable);
+	CHECK(ctrlField(ctrlWrites[2], CtrlReg::En::Bit::Mask, CtrlReg::En::Bit::Pos) == CtrlReg::En::Val::Enable);
+}
+
+void emergencyStopReuse()
+{
+	shared_ptr<Bus> bus = simBus();
+	EmergencyStop estop;
+	alignas(Motor) unsigned char storage[sizeof(Motor)];
+
+	// Another motor constructed at the address of a removed one.
+	Motor *m0 = new (storage) Motor(bus, MHz(50), BaseAddr0);
+	estop.add(*m0);
+	estop.remove(*m0);
+	m0->~Motor();
+
+	Motor *m1 = new (storage) Motor(bus, MHz(50), BaseAddr1);
+	m1->outputEnable(true);
+	estop.add(*m1);
+	estop.trigger();
+
+	CHECK(estop.lastFailNum() == 0);
+	CHECK(m1->regMap().ctrl.en() == CtrlReg::En::Val::Disable);
+
+	// Staged CTRL must not be written by trigger().
+	estop.resync();
+	m1->regMap().ctrl.pwmMaxcnt(static_cast<uint16_t>(5U), true);
+
+	bool isThrown = false;
+	try {
+		estop.refresh();
+	} catch (const std::runtime_error &) {
+		isThrown = true;
+	}
+	CHECK(isThrown);
+
+	m1->~Motor();
+}
+
+void sequencerStopRestart()
+{
+	Motor motor(simBus(), MHz(50), BaseAddr0);
+	CommutationSequencer seq(motor);
+
+	// stop() breaks the wait for the last long step.
+	seq.start({milliseconds(1), milliseconds(1), seconds(10)});
+	std::this_thread::sleep_for(milliseconds(50));
+
+	const auto begin = std::chrono::steady_clock::now();
+	seq.stop();
+	CHECK((std::chrono::steady_clock::now() - begin) < seconds(1));
+
+	const uint32_t phase = motor.regMap().ctrl.phase();
+	CHECK(phase == 2U);
+	CHECK(seq.stats().stepNum == 2);
+
+	// The next start continues from the written phase.
+	seq.start({microseconds(100)});
+	seq.wait();
+	CHECK(motor.regMap().ctrl.phase() == 3U);
+}
+
+void ditherAfterPeriod()
+{
+	Motor motor(simBus(), MHz(50), BaseAddr0);
+	DutyDither dither(microseconds(100));
+	double total = 0.;
+
+	motor.pwmPeriod(microseconds(8), 0);
+	motor.pwmDuty(50);
+	dither.add(motor);
+
+	dither.duty(motor, 50.5);
+	dither.pwmPeriod(motor, microseconds(16), 1);
+
+	for (int i = 0; i < 100; i++) {
+		dither.update();
+		total += static_cast<double>(motor.regMap().pwmCmp.pwmCmp());
+	}
+	CHECK(total == 10100.);
+
+	// Written even if PWM_CMP was changed by others.
+	motor.pwmDuty(10);
+	dither.duty(motor, 50.);
+	dither.update();
+	CHECK(motor.regMap().pwmCmp.pwmCmp() == 100U);
+}
+
+void fleetSelfPost()
+{
+	shared_ptr<Bus> bus = simBus();
+	FleetRuntime runtime(2, false);
+	atomic<int> runNum(0);
+	const std::size_t id = runtime.add(std::unique_ptr<Motor>(new Motor(bus, MHz(50), BaseAddr0)));
+
+	runtime.start();
+	runtime.post(id, [&](Motor &) {
+		runNum++;
+		// Tasks can post to their own unit.
+		runtime.post(id, [&](Motor &) {
+			runNum++;
+		});
+	});
+
+	const auto deadline = std::chrono::steady_clock::now() + seconds(5);
+	while ((runNum.load() < 2) && (std::chrono::steady_clock::now() < deadline)) {
+		std::this_thread::sleep_for(milliseconds(1));
+	}
+	runtime.stop();
+
+	CHECK(runNum.load() == 2);
+}
+
+const std::map<string, std::function<void()>> Cases = {
+	{"channel_push_pop_status", channelPushPopStatus},
+	{"daemon_apply_merge",      daemonApplyMerge},
+	{"emergency_stop_reuse",    emergencyStopReuse},
+	{"sequencer_stop_restart",  sequencerStopRestart},
+	{"dither_after_period",     ditherAfterPeriod},
+	{"fleet_self_post",         fleetSelfPost}
+};
+} // End of "namespace"
+
+int main(int argc, char **argv)
+{
+	if (argc != 2) {
+		cerr << "Usage: " << argv[0] << " case" << endl;
+		return EXIT_FAILURE;
+	}
+
+	const auto itr = Cases.find(argv[1]);
+
+	if (itr == Cases.end()) {
+		cerr << "Unknown case: " << argv[1] << endl;
+		return EXIT_FAILURE;
+	}
+
+	try {
+		itr->second();
+	} catch (const std::exception &e) {
+		cerr << "Unexpected exception: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
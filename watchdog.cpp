@@ -0,0 +1,241 @@
+#include <libbldcm/watchdog.hpp>
+#include <libbldcm/register_map.hpp>
+#include <libbldcm.hpp>
+
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+using std::chrono::nanoseconds;
+using std::chrono::duration_cast;
+
+namespace bldcm {
+
+//========  Watchdog class ========
+// Public
+const Watchdog::Config Watchdog::DefaultConfig = {
+	std::chrono::milliseconds(1),
+	std::chrono::milliseconds(500),
+	std::chrono::milliseconds(100)
+};
+
+Watchdog::Watchdog() noexcept(false)
+	: Watchdog(DefaultConfig)
+{
+}
+
+Watchdog::Watchdog(const Config &config) noexcept(false)
+	: _config(config), _isStopRequested(false),
+	  _stats{0, 0, nanoseconds::max(), nanoseconds::zero(), nanoseconds::zero(), nanoseconds::zero()}
+{
+}
+
+Watchdog::~Watchdog()
+{
+	this->stop();
+}
+
+void Watchdog::watch(Motor &motor) noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+
+	this->_entries.push_back(Entry{&motor, false, 0, false, false, Clock::time_point(), Clock::time_point::max()});
+}
+
+void Watchdog::unwatch(const Motor &motor) noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	auto &entries = this->_entries;
+
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [&motor](const Entry &e) { return e.motor == &motor; }), entries.end());
+}
+
+void Watchdog::onFault(const FaultCallback &callback) noexcept(true)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	this->_callback = callback;
+}
+
+void Watchdog::start() noexcept(false)
+{
+	if (!this->_thread.joinable()) {
+		this->_isStopRequested = false;
+		this->_thread = std::thread(&Watchdog::_run, this);
+	}
+}
+
+void Watchdog::stop() noexcept(true)
+{
+	if (this->_thread.joinable()) {
+		{
+			lock_guard<mutex> lock(this->_mtx);
+			this->_isStopRequested = true;
+		}
+		this->_cv.notify_all();
+		this->_thread.join();
+	}
+}
+
+void Watchdog::check() noexcept(true)
+{
+	unique_lock<mutex> lock(this->_mtx);
+	this->_checkLocked();
+	this->_notify(lock);
+}
+
+unique_lock<mutex> Watchdog::lock() noexcept(false)
+{
+	return unique_lock<mutex>(this->_mtx);
+}
+
+Watchdog::Stats Watchdog::stats() noexcept(false)
+{
+	lock_guard<mutex> lock(this->_mtx);
+	return this->_stats;
+}
+
+// Private
+void Watchdog::_run() noexcept(true)
+{
+	unique_lock<mutex> lock(this->_mtx);
+	Clock::time_point next = Clock::now();
+
+	while (!this->_isStopRequested) {
+		this->_checkLocked();
+		this->_notify(lock);
+		next += this->_config.checkPeriod;
+		// The mutex is released while waiting, so that other threads can use motors.
+		this->_cv.wait_until(lock, next, [this] { return this->_isStopRequested; });
+	}
+}
+
+void Watchdog::_checkLocked() noexcept(true)
+{
+	const Clock::time_point begin = Clock::now();
+
+	for (Entry &entry : this->_entries) {
+		Motor &motor = *entry.motor;
+		uint32_t freqtgt;
+		bool     isEnabled;
+		Motor::Status status;
+
+		// Expected state is taken from caches, so it costs no bus access.
+		try {
+			freqtgt   = motor.regMap().freqtgt.freqtgt(true);
+			isEnabled = (motor.regMap().ctrl.en(true) == CtrlReg::En::Val::Enable);
+		} catch (...) {
+			continue;
+		}
+
+		const bool isRunningExpected = isEnabled && (freqtgt != static_cast<uint32_t>(0U));
+
+		if (!isRunningExpected) {
+			entry.isRunningExpected = false;
+			entry.isFaulted = false;
+			continue;
+		}
+
+		const Clock::time_point now = Clock::now();
+
+		if ((!entry.isRunningExpected) || (entry.freqtgt != freqtgt)) {
+			entry.isRunningExpected = true;
+			entry.freqtgt      = freqtgt;
+			entry.isReflected  = false;
+			entry.isFaulted    = false;
+			entry.setpointTime = now;
+			entry.stopSince    = Clock::time_point::max();
+		}
+
+		try {
+			status = motor.status();
+		} catch (...) {
+			continue;
+		}
+
+		if (status.isReflectedFreq) {
+			entry.isReflected = true;
+		}
+
+		if (!status.isStopping) {
+			entry.stopSince = Clock::time_point::max();
+		} else if (entry.stopSince == Clock::time_point::max()) {
+			entry.stopSince = now;
+		}
+
+		if ((entry.stopSince != Clock::time_point::max()) &&
+		    ((now - entry.stopSince) >= this->_config.stallTimeout)) {
+			this->_fault(entry, Fault::stall, entry.stopSince + this->_config.stallTimeout);
+		} else if ((!entry.isReflected) && ((now - entry.setpointTime) >= this->_config.reflectTimeout)) {
+			this->_fault(entry, Fault::noReflect, entry.setpointTime + this->_config.reflectTimeout);
+		}
+	}
+
+	const nanoseconds passTime = duration_cast<nanoseconds>(Clock::now() - begin);
+
+	this->_stats.passNum++;
+	this->_stats.maxPassTime = std::max(this->_stats.maxPassTime, passTime);
+}
+
+void Watchdog::_fault(Entry &entry, const Fault fault, const Clock::time_point &deadline) noexcept(true)
+{
+	try {
+		entry.motor->outputEnable(false);
+	} catch (...) {
+		// Retry at the next pass.
+		return;
+	}
+
+	const nanoseconds detection = duration_cast<nanoseconds>(Clock::now() - deadline);
+
+	if (!entry.isFaulted) {
+		entry.isFaulted = true;
+		this->_stats.faultNum++;
+		this->_stats.minDetection    = std::min(this->_stats.minDetection, detection);
+		this->_stats.maxDetection    = std::max(this->_stats.maxDetection, detection);
+		this->_stats.totalDetection += detection;
+	}
+
+	if (this->_callback) {
+		try {
+			this->_detected.push_back(Detected{entry.motor, fault});
+		} catch (...) {
+			// Output is already disabled, only the notification is lost.
+		}
+	}
+}
+
+void Watchdog::_notify(unique_lock<mutex> &lock) noexcept(true)
+{
+	if (this->_detected.empty()) {
+		return;
+	}
+
+	std::vector<Detected> detected;
+	FaultCallback callback;
+
+	try {
+		callback = this->_callback;
+	} catch (...) {
+		this->_detected.clear();
+		return;
+	}
+	detected.swap(this->_detected);
+
+	lock.unlock();
+	for (const Detected &d : detected) {
+		try {
+			callback(*d.motor, d.fault);
+		} catch (...) {
+			// Exceptions from callback must not stop watching others.
+		}
+	}
+	lock.lock();
+}
+
+} // End of "namespace bldcm"
+